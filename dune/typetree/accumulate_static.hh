@@ -6,6 +6,13 @@
 #ifndef DUNE_TYPETREE_ACCUMULATE_STATIC_HH
 #define DUNE_TYPETREE_ACCUMULATE_STATIC_HH
 
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/rangeutilities.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/typetree/nodeinterface.hh>
 #include <dune/typetree/nodetags.hh>
@@ -31,6 +38,12 @@ namespace Dune {
       {
         static const result_type result = r1 || r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 || r2;
+      }
     };
 
     //! Statically combine two values of type result_type using &&.
@@ -42,6 +55,12 @@ namespace Dune {
       {
         static const result_type result = r1 && r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 && r2;
+      }
     };
 
     //! Statically combine two values of type result_type using +.
@@ -53,6 +72,12 @@ namespace Dune {
       {
         static const result_type result = r1 + r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 + r2;
+      }
     };
 
     //! Statically combine two values of type result_type using -.
@@ -64,6 +89,12 @@ namespace Dune {
       {
         static const result_type result = r1 - r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 - r2;
+      }
     };
 
     //! Statically combine two values of type result_type using *.
@@ -75,6 +106,12 @@ namespace Dune {
       {
         static const result_type result = r1 * r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 * r2;
+      }
     };
 
     //! Statically combine two values of type result_type by returning their minimum.
@@ -86,6 +123,12 @@ namespace Dune {
       {
         static const result_type result = r1 < r2 ? r1 : r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 < r2 ? r1 : r2;
+      }
     };
 
     //! Statically combine two values of type result_type by returning their maximum.
@@ -97,6 +140,12 @@ namespace Dune {
       {
         static const result_type result = r1 > r2 ? r1 : r2;
       };
+
+      //! Combine two values at run time.
+      static constexpr result_type combine(result_type r1, result_type r2)
+      {
+        return r1 > r2 ? r1 : r2;
+      }
     };
 
 
@@ -270,6 +319,136 @@ namespace Dune {
 
     };
 
+    namespace {
+
+      // implementation of the run-time traversal algorithm
+
+      //! Checks whether the subtree rooted at Node contains a node with a dynamic degree.
+      template<typename Node>
+      constexpr bool has_dynamic_degree()
+      {
+        if constexpr (std::is_same_v<NodeTag<Node>,DynamicPowerNodeTag>)
+          return true;
+        else if constexpr (Node::isLeaf)
+          return false;
+        else
+          return unpackIntegerSequence([](auto... i) {
+              return (has_dynamic_degree<typename Node::template Child<i>::Type>() || ... || false);
+            }, std::make_index_sequence<StaticDegree<Node>::value>());
+      }
+
+      //! Includes the per-node result of Node in the current value if the functor wants to visit it.
+      template<typename Node, typename Functor, typename Reduction, typename TreePath>
+      constexpr typename Functor::result_type accumulate_node_dynamic(typename Functor::result_type current_value)
+      {
+        if constexpr (Functor::template doVisit<Node,TreePath>::value)
+          return Reduction::combine(current_value,Functor::template visit<Node,TreePath>::result);
+        else
+          return current_value;
+      }
+
+      //! Accumulation over a subtree without dynamic nodes. As the result only depends on the
+      //! node types, this does not need the tree and is evaluated at compile time for a constant
+      //! current value.
+      template<typename Node, typename Functor, typename Reduction, typename ParentChildReduction, typename TreePath>
+      constexpr typename Functor::result_type accumulate_value_static_subtree(typename Functor::result_type current_value)
+      {
+        if constexpr (Node::isLeaf)
+          return accumulate_node_dynamic<Node,Functor,Reduction,TreePath>(current_value);
+        else {
+          unpackIntegerSequence([&](auto... i) {
+              ((current_value = accumulate_value_static_subtree<
+                  typename Node::template Child<decltype(i)::value>::Type,
+                  Functor,Reduction,ParentChildReduction,
+                  decltype(push_back(TreePath{},i))>(current_value)), ...);
+            }, std::make_index_sequence<StaticDegree<Node>::value>());
+          return accumulate_node_dynamic<Node,Functor,ParentChildReduction,TreePath>(current_value);
+        }
+      }
+
+      //! Accumulation over a subtree with dynamic nodes, which are iterated at run time.
+      //! The children of dynamic power nodes get tree paths with a run-time index.
+      template<typename Node, typename Functor, typename Reduction, typename ParentChildReduction, typename TreePath>
+      typename Functor::result_type accumulate_value_dynamic(const Node& node, typename Functor::result_type current_value)
+      {
+        if constexpr (not has_dynamic_degree<Node>())
+          return accumulate_value_static_subtree<Node,Functor,Reduction,ParentChildReduction,TreePath>(current_value);
+        else if constexpr (std::is_same_v<NodeTag<Node>,DynamicPowerNodeTag>) {
+          typedef typename Node::ChildType child;
+          typedef decltype(push_back(TreePath{},std::size_t(0))) child_tree_path;
+          for (std::size_t i = 0; i < node.degree(); ++i)
+            current_value = accumulate_value_dynamic<child,Functor,Reduction,ParentChildReduction,child_tree_path>(node.child(i),current_value);
+          return accumulate_node_dynamic<Node,Functor,ParentChildReduction,TreePath>(current_value);
+        }
+        else {
+          Hybrid::forEach(Dune::range(index_constant<StaticDegree<Node>::value>{}), [&](auto i) {
+            typedef typename Node::template Child<i>::Type child;
+            typedef decltype(push_back(TreePath{},i)) child_tree_path;
+            current_value = accumulate_value_dynamic<child,Functor,Reduction,ParentChildReduction,child_tree_path>(node.child(i),current_value);
+          });
+          return accumulate_node_dynamic<Node,Functor,ParentChildReduction,TreePath>(current_value);
+        }
+      }
+
+    } // anonymous namespace
+
+    //! Accumulate a value over the nodes of a TypeTree that may contain dynamic nodes.
+    /**
+     * This struct is the run-time counterpart of AccumulateValue. It uses the same functor
+     * and start value, and it also supports trees with a DynamicPowerNode. The functor computes
+     * the per-node results from the node type and tree path type, as for AccumulateValue. The
+     * children of a dynamic power node are iterated at run time, and their tree paths contain
+     * a run-time index at the position of the dynamic power node.
+     *
+     * Subtrees without dynamic nodes are folded by constexpr functions on the node types. If
+     * the whole tree is static, result() returns AccumulateValue::result, which is computed at
+     * compile time.
+     *
+     * \tparam Tree        The tree to iterate over.
+     * \tparam Functor     The compile-time functor used for visiting each node, see AccumulateValue.
+     * \tparam Reduction   The reduction operator used to accumulate the per-node results.
+     *
+     * In addition to the interface required by AccumulateValue, the reduction operator must provide
+     * a function to combine two values at run time:
+     *
+     * \code
+     * template<typename result_type>
+     * struct ReductionOperator
+     * {
+     *
+     *   // combine two per-node results at run time
+     *   static constexpr result_type combine(result_type r1, result_type r2);
+     *
+     * };
+     * \endcode
+     *
+     * All reduction operators in this file provide this function.
+     *
+     * \tparam startValue  The starting value fed into the initial accumulation step.
+     * \tparam ParentChildReduction  The reduction operator used to combine the accumulated result
+     *                               of the children with the result of the parent.
+     */
+    template<typename Tree, typename Functor, typename Reduction, typename Functor::result_type startValue, typename ParentChildReduction = Reduction>
+    struct DynamicAccumulateValue
+    {
+
+      //! The result type of the computation.
+      typedef typename Functor::result_type result_type;
+
+      //! Whether the result only depends on the tree type.
+      static const bool isStatic = not has_dynamic_degree<Tree>();
+
+      //! Calculates the accumulated result for the given tree.
+      static result_type result(const Tree& tree)
+      {
+        if constexpr (isStatic)
+          return AccumulateValue<Tree,Functor,Reduction,startValue,ParentChildReduction>::result;
+        else
+          return accumulate_value_dynamic<Tree,Functor,Reduction,ParentChildReduction,HybridTreePath<>>(tree,startValue);
+      }
+
+    };
+
     //! Tag selecting a type reduction algorithm that visits the tree in
     //! postorder and performs a flat reduction over the resulting type list.
     struct flattened_reduction;
@@ -449,6 +628,44 @@ namespace Dune {
         : public accumulate_type_generic_composite_node<CompositeNode,Policy,current_type,TreePath>
       {};
 
+      //! DynamicPowerNode specialization. The result type cannot depend on the run-time number of
+      //! children, so the child type is visited once as representative of all children, using a
+      //! tree path with a run-time index.
+      template<typename DynamicPowerNode, typename Policy, typename current_type, typename TreePath>
+      struct accumulate_type<DynamicPowerNode,Policy,current_type,TreePath,DynamicPowerNodeTag>
+      {
+
+        typedef decltype(push_back(TreePath{},std::size_t(0))) child_tree_path;
+
+        typedef typename DynamicPowerNode::ChildType child;
+
+        typedef typename accumulate_type<
+          child,
+          Policy,
+          typename propagate_type_down_tree<
+            current_type,
+            child_tree_path,
+            typename Policy::start_type,
+            typename Policy::reduction_strategy
+            >::type,
+          child_tree_path,
+          NodeTag<child>
+          >::type children_result_type;
+
+        typedef typename accumulate_type_node_helper<
+          DynamicPowerNode,
+          typename Policy::functor,
+          typename Policy::parent_child_reduction,
+          children_result_type,
+          TreePath,
+          Policy::functor::template doVisit<
+            DynamicPowerNode,
+            TreePath
+            >::value
+          >::type type;
+
+      };
+
     } // anonymous namespace
 
 
@@ -548,6 +765,9 @@ namespace Dune {
      * This struct implements an algorithm for iterating over a tree and
      * calculating an accumulated type at compile time.
      *
+     * For a DynamicPowerNode, the child type is visited once in place of all children,
+     * with a run-time index in its tree path.
+     *
      * \tparam Tree        The tree to iterate over.
      * \tparam Policy      Model of TypeAccumulationPolicy controlling the behavior
      *                     of the algorithm.
@@ -579,7 +799,7 @@ namespace Dune {
         //! This is the specialization overload doing leaf traversal.
         template<class T, class TreePath, class V, class U,
           std::enable_if_t<std::decay_t<T>::isLeaf, int> = 0>
-        auto hybridApplyToTree(T&& tree, TreePath treePath, V&& visitor, U&& current_val)
+        constexpr auto hybridApplyToTree(T&& tree, TreePath treePath, V&& visitor, U&& current_val)
         {
           return visitor.leaf(tree, treePath, std::forward<U>(current_val));
         }
@@ -587,7 +807,7 @@ namespace Dune {
         //! This is the general overload doing child traversal.
         template<class T, class TreePath, class V, class U,
           std::enable_if_t<not std::decay_t<T>::isLeaf, int> = 0>
-        auto hybridApplyToTree(T&& tree, TreePath treePath, V&& visitor, U&& current_val)
+        constexpr auto hybridApplyToTree(T&& tree, TreePath treePath, V&& visitor, U&& current_val)
         {
           using Tree = std::remove_reference_t<T>;
           using Visitor = std::remove_reference_t<V>;
@@ -600,8 +820,9 @@ namespace Dune {
           // the tree must support either dynamic or static traversal
           static_assert(allowDynamicTraversal::value || allowStaticTraversal::value);
 
-          // the visitor may specify preferred dynamic traversal
-          using preferDynamicTraversal = std::bool_constant<Visitor::treePathType == TreePathType::dynamic>;
+          // the visitor may specify preferred dynamic traversal or a static degree threshold
+          using preferDynamicTraversal = std::bool_constant<Visitor::treePathType == TreePathType::dynamic
+            or Detail::dynamicChildIndices<Visitor,Tree>()>;
 
           // declare rule that applies visitor and current value to a child i. Returns next value
           auto apply_i = [&](auto&& value, const auto& i){
@@ -686,6 +907,8 @@ namespace Dune {
        *    on the next visited node.
        *
        * @note Tree may be const or non-const
+       * @note The traversal can be evaluated in constant expressions if the tree and the visitor
+       * support it, e.g. for trees built from LeafNode, ValuePowerNode and ValueCompositeNode.
        * @note If the carried type is always the same, consider applyToTree
        * which is less demanding on the compiler.
        *
@@ -699,7 +922,7 @@ namespace Dune {
        * @return auto    Result of the last call on the visitor
        */
       template<typename Tree, typename Visitor, typename Init>
-      auto hybridApplyToTree(Tree&& tree, Visitor&& visitor, Init&& init)
+      constexpr auto hybridApplyToTree(Tree&& tree, Visitor&& visitor, Init&& init)
       {
         return Impl::hybridApplyToTree(tree, hybridTreePath(), visitor, init);
       }
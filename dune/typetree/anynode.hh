@@ -0,0 +1,261 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_ANYNODE_HH
+#define DUNE_TYPETREE_ANYNODE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetree/nodeconcepts.hh>
+
+#include <dune/typetree/nodeinterface.hh>
+#include <dune/typetree/nodetags.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    class AnyNode;
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // The operations of a node type used by AnyNode. There is a single static instance for each
+      // node type, so an AnyNode only stores two pointers.
+      struct AnyNodeVTable
+      {
+        const std::type_info& (*type)();
+        const std::type_info& (*nodeTag)();
+        std::size_t (*degree)(const void* node);
+        AnyNode (*child)(const void* node, std::size_t i);
+      };
+
+      template<typename Node>
+      struct AnyNodeOperations;
+
+      template<typename Node>
+      inline constexpr AnyNodeVTable anyNodeVTable = {
+        &AnyNodeOperations<Node>::type,
+        &AnyNodeOperations<Node>::nodeTag,
+        &AnyNodeOperations<Node>::degree,
+        &AnyNodeOperations<Node>::child
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! A type-erased, non-owning reference to a node of any tree.
+    /**
+     * \code
+     #include <dune/typetree/anynode.hh>
+     * \endcode
+     * AnyNode wraps a reference to an arbitrary node behind a compact table of function pointers,
+     * which is shared by all nodes of the same type. It provides the runtime part of the node
+     * interface, i.e. the kind of node, its degree and its children, which are again returned as
+     * AnyNode objects. Code written against AnyNode, e.g. using applyToAnyTree(), is thus
+     * instantiated once for all trees. This reduces compile time and binary size of cold code
+     * paths like setup, output or debugging, while hot paths keep using the statically typed
+     * nodes. The wrapped node can be recovered with target() if its type is known.
+     *
+     * The referenced node must outlive the AnyNode.
+     */
+    class AnyNode
+    {
+
+    public:
+
+      //! Wraps a reference to node.
+      template<Concept::TreeNode Node>
+        requires (not std::is_same_v<std::decay_t<Node>,AnyNode>)
+      AnyNode (const Node& node)
+        : _node(&node)
+        , _vtable(&Impl::anyNodeVTable<Node>)
+      {}
+
+      //! Returns whether the node is a leaf node.
+      bool isLeaf () const
+      {
+        return nodeTag() == typeid(LeafNodeTag);
+      }
+
+      //! Returns whether the node is a power node with a static or dynamic degree.
+      bool isPower () const
+      {
+        return nodeTag() == typeid(PowerNodeTag) or nodeTag() == typeid(DynamicPowerNodeTag);
+      }
+
+      //! Returns whether the node is a composite node.
+      bool isComposite () const
+      {
+        return nodeTag() == typeid(CompositeNodeTag);
+      }
+
+      //! Returns the type of the NodeTag of the wrapped node.
+      const std::type_info& nodeTag () const
+      {
+        return _vtable->nodeTag();
+      }
+
+      //! Returns the type of the wrapped node.
+      const std::type_info& type () const
+      {
+        return _vtable->type();
+      }
+
+      //! Returns the number of children, which is 0 for leaf nodes.
+      std::size_t degree () const
+      {
+        return _vtable->degree(_node);
+      }
+
+      //! Returns the i-th child.
+      AnyNode child (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return _vtable->child(_node,i);
+      }
+
+      //! Returns a pointer to the wrapped node if it has type Node, and a null pointer otherwise.
+      template<typename Node>
+      const Node* target () const
+      {
+        return type() == typeid(Node) ? static_cast<const Node*>(_node) : nullptr;
+      }
+
+      //! Checks whether both objects refer to the same node.
+      friend bool operator== (const AnyNode& a, const AnyNode& b)
+      {
+        return a._node == b._node and a.type() == b.type();
+      }
+
+    private:
+
+      const void* _node;
+      const Impl::AnyNodeVTable* _vtable;
+
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename Node>
+      struct AnyNodeOperations
+      {
+        static const Node& node (const void* p)
+        {
+          return *static_cast<const Node*>(p);
+        }
+
+        static const std::type_info& type ()
+        {
+          return typeid(Node);
+        }
+
+        static const std::type_info& nodeTag ()
+        {
+          return typeid(NodeTag<Node>);
+        }
+
+        static std::size_t degree (const void* p)
+        {
+          if constexpr (Node::isLeaf)
+            return 0;
+          else
+            return node(p).degree();
+        }
+
+        template<std::size_t k>
+        static AnyNode childAt (const void* p)
+        {
+          return AnyNode(node(p).child(index_constant<k>()));
+        }
+
+        // composite children have different types, so they are looked up in a table
+        template<std::size_t... k>
+        static AnyNode compositeChild (const void* p, std::size_t i, std::index_sequence<k...>)
+        {
+          static constexpr AnyNode (*children[])(const void*) = { &childAt<k>... };
+          return children[i](p);
+        }
+
+        static AnyNode child (const void* p, std::size_t i)
+        {
+          if constexpr (Node::isLeaf)
+            return AnyNode(node(p));
+          else if constexpr (Concept::UniformInnerTreeNode<Node>)
+            return AnyNode(node(p).child(i));
+          else
+            return compositeChild(p,i,std::make_index_sequence<Node::degree()>());
+        }
+      };
+
+      template<typename Visitor>
+      void applyToAnyTree (AnyNode node, std::vector<std::size_t>& treePath, Visitor& visitor)
+      {
+        using TreePath = std::span<const std::size_t>;
+        if (node.isLeaf()) {
+          visitor.leaf(node,TreePath(treePath));
+          return;
+        }
+        visitor.pre(node,TreePath(treePath));
+        for (std::size_t i = 0; i < node.degree(); ++i) {
+          AnyNode child = node.child(i);
+          visitor.beforeChild(node,child,TreePath(treePath),i);
+          if (i > 0)
+            visitor.in(node,TreePath(treePath));
+          if constexpr (Visitor::template VisitChild<AnyNode,AnyNode,TreePath>::value) {
+            treePath.push_back(i);
+            Impl::applyToAnyTree(child,treePath,visitor);
+            treePath.pop_back();
+          }
+          visitor.afterChild(node,child,TreePath(treePath),i);
+        }
+        visitor.post(node,TreePath(treePath));
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Apply visitor to a type-erased tree.
+    /**
+     * \code
+     #include <dune/typetree/anynode.hh>
+     * \endcode
+     * This function traverses the tree like applyToTree() with a dynamic traversal, but at run
+     * time, so it is only instantiated once per visitor type and not per tree type. The visitor
+     * has the interface of DefaultVisitor, but all nodes are passed as AnyNode objects, and the
+     * tree path is passed as a `std::span<const std::size_t>` that is only valid during the call.
+     *
+     * \param tree    The root of the tree the visitor will be applied to.
+     * \param visitor The visitor to apply to the tree.
+     */
+    template<typename Visitor>
+    void applyToAnyTree (AnyNode tree, Visitor&& visitor)
+    {
+      std::vector<std::size_t> treePath;
+      Impl::applyToAnyTree(tree,treePath,visitor);
+    }
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_ANYNODE_HH
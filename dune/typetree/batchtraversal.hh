@@ -0,0 +1,224 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_BATCHTRAVERSAL_HH
+#define DUNE_TYPETREE_BATCHTRAVERSAL_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/rangeutilities.hh>
+#include <dune/common/typetree/childaccess.hh>
+#include <dune/common/typetree/nodeconcepts.hh>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/visitor.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! The nodes at the same position in a batch of structurally identical trees.
+    /**
+     * \code
+     #include <dune/typetree/batchtraversal.hh>
+     * \endcode
+     * A NodeBatch is a lightweight view that is passed to the visitor by applyToTreeBatch() in place
+     * of a single node. It refers to an array of pointers to the nodes of all trees, which
+     * applyToTreeBatch() resolves once per position from the nodes of the parent batch. Accessing
+     * a node is thus a single indirection, independent of the depth of the node.
+     *
+     * \tparam Tree      The type of the trees, which may be const.
+     * \tparam TreePath  The type of the tree path of the nodes.
+     */
+    template<typename Tree, typename TreePath>
+    class NodeBatch
+    {
+
+    public:
+
+      //! The type of the nodes, which is const if the trees are const.
+      typedef std::remove_reference_t<decltype(child(std::declval<Tree&>(),std::declval<TreePath>()))> Node;
+
+      //! The type-erased pointer to a node, which is const if the trees are const.
+      typedef std::conditional_t<std::is_const_v<Tree>,const void*,void*> NodePointer;
+
+      //! Creates a view of the nodes at treePath in trees, where nodes[e] points to the node of the e-th tree.
+      NodeBatch (std::span<Tree> trees, TreePath treePath, std::span<const NodePointer> nodes)
+        : _trees(trees)
+        , _treePath(treePath)
+        , _nodes(nodes)
+      {
+        assert(trees.size() == nodes.size());
+      }
+
+      //! The number of trees in the batch.
+      std::size_t size () const
+      {
+        return _nodes.size();
+      }
+
+      //! The node of the e-th tree.
+      Node& operator[] (std::size_t e) const
+      {
+        return *static_cast<Node*>(_nodes[e]);
+      }
+
+      //! The node of the first tree, which represents the structure of all nodes in the batch.
+      Node& front () const
+      {
+        return (*this)[0];
+      }
+
+      //! The tree path of the nodes.
+      const TreePath& treePath () const
+      {
+        return _treePath;
+      }
+
+      //! The trees of the batch.
+      std::span<Tree> trees () const
+      {
+        return _trees;
+      }
+
+    private:
+
+      std::span<Tree> _trees;
+      TreePath _treePath;
+      std::span<const NodePointer> _nodes;
+
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // The depth of the tree, i.e. the number of nodes on the longest path from the root to a leaf.
+      template<typename Node>
+      constexpr std::size_t batchTreeDepth ()
+      {
+        if constexpr (Node::isLeaf)
+          return 1;
+        else if constexpr (Concept::UniformInnerTreeNode<Node>)
+          return 1 + batchTreeDepth<typename Node::ChildType>();
+        else
+          return unpackIntegerSequence([](auto... k) {
+              return 1 + std::max({std::size_t(0),batchTreeDepth<typename Node::template Child<k>::Type>()...});
+            }, std::make_index_sequence<Node::degree()>());
+      }
+
+      // Visits the nodes of a batch. The structure of the nodes is taken from the first tree, and
+      // the visitor is passed NodeBatch objects instead of nodes. The pointers to the children are
+      // stored at the front of buffer, which provides space for all levels below the nodes.
+      template<class Tree, class TreePath, class V>
+      void applyToTreeBatch (const NodeBatch<Tree,TreePath>& nodes, std::span<typename NodeBatch<Tree,TreePath>::NodePointer> buffer, V&& visitor)
+      {
+        using Node = std::remove_const_t<typename NodeBatch<Tree,TreePath>::Node>;
+        using Visitor = std::remove_reference_t<V>;
+        const TreePath& treePath = nodes.treePath();
+
+        if constexpr (Node::isLeaf)
+          visitor.leaf(nodes,treePath);
+        else {
+          visitor.pre(nodes,treePath);
+
+          // the visitor may specify preferred dynamic traversal or a static degree threshold
+          auto indices = [&]{
+            if constexpr (Detail::dynamicChildIndices<Visitor,Node>())
+              return Dune::range(std::size_t(nodes.front().degree()));
+            else
+              return Dune::range(nodes.front().degree());
+          }();
+
+          if constexpr (Concept::InnerTreeNode<Node>) {
+            auto childPointers = buffer.first(nodes.size());
+            Hybrid::forEach(indices, [&](auto i) {
+              using Child = std::decay_t<decltype(nodes.front().child(i))>;
+              auto childTreePath = Dune::TypeTree::push_back(treePath,i);
+              for (std::size_t e = 0; e < nodes.size(); ++e)
+                childPointers[e] = &nodes[e].child(i);
+              NodeBatch<Tree,decltype(childTreePath)> children(nodes.trees(),childTreePath,childPointers);
+
+              visitor.beforeChild(nodes,children,treePath,i);
+
+              if (i>0)
+                visitor.in(nodes,treePath);
+
+              if constexpr (Visitor::template VisitChild<Node,Child,TreePath>::value)
+                Impl::applyToTreeBatch(children,buffer.subspan(nodes.size()),visitor);
+
+              visitor.afterChild(nodes,children,treePath,i);
+            });
+          }
+          visitor.post(nodes,treePath);
+        }
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Apply visitor to a batch of structurally identical trees.
+    /**
+     * \code
+     #include <dune/typetree/batchtraversal.hh>
+     * \endcode
+     * This function traverses the common structure of all trees once and calls the visitor with
+     * the corresponding nodes of all trees at each position. The visitor has the same interface as
+     * for applyToTree(), but is passed NodeBatch objects in place of the nodes, e.g.
+     * \code
+     * struct Kernel : public DefaultVisitor, public StaticTraversal, public VisitTree
+     * {
+     *   template<class Leaves, class TreePath>
+     *   void leaf(const Leaves& leaves, TreePath treePath)
+     *   {
+     *     for (std::size_t e = 0; e < leaves.size(); ++e)
+     *       compute(leaves[e]);
+     *   }
+     * };
+     * \endcode
+     * Compared to calling applyToTree() for each tree, the cost of the traversal and of the
+     * visitor callbacks is paid once for the whole batch, and the leaf kernels can loop (and
+     * vectorize) across the trees. The VisitChild template of the visitor is instantiated with the
+     * node types, not with the NodeBatch types.
+     *
+     * All trees must have the same structure, in particular the same degrees of dynamic nodes.
+     * The structure is taken from the first tree. If the batch is empty, the visitor is not called.
+     *
+     * \param trees   The trees the visitor will be applied to.
+     * \param visitor The visitor to apply to the trees.
+     */
+    template<typename Tree, std::size_t extent, typename Visitor>
+    void applyToTreeBatch (std::span<Tree,extent> trees, Visitor&& visitor)
+    {
+      if (trees.empty())
+        return;
+      // one pointer per tree and level, allocated once for the whole traversal
+      using Root = NodeBatch<Tree,HybridTreePath<>>;
+      std::vector<typename Root::NodePointer> buffer(Impl::batchTreeDepth<std::remove_const_t<Tree>>() * trees.size());
+      for (std::size_t e = 0; e < trees.size(); ++e)
+        buffer[e] = &trees[e];
+      auto rootPointers = std::span(buffer).first(trees.size());
+      Impl::applyToTreeBatch(Root(trees,hybridTreePath(),rootPointers),std::span(buffer).subspan(trees.size()),visitor);
+    }
+
+    //! \} group Tree Traversal
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_BATCHTRAVERSAL_HH
@@ -0,0 +1,241 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_BOUNDEDDYNAMICPOWERNODE_HH
+#define DUNE_TYPETREE_BOUNDEDDYNAMICPOWERNODE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/reservedvector.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/nodeinterface.hh>
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/utility.hh>
+#include <dune/typetree/typetraits.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    /** \brief Collect a bounded, run-time number of instances of type T within a \ref TypeTree.
+     *
+     * The node behaves like DynamicPowerNode, but stores its children in a Dune::ReservedVector
+     * with inline capacity instead of a heap-allocated std::vector. The upper bound of the degree
+     * is available at compile time as maxDegree(), see MaxDegree. Thus TreeInfo can compute the
+     * depth of trees containing such nodes, as well as upper bounds of their node and leaf
+     * counts, e.g. to size a FixedCapacityStack.
+     *
+     * \tparam T        Type of the tree-node children
+     * \tparam capacity The maximum number of children
+     */
+    template<typename T, std::size_t capacity>
+    class BoundedDynamicPowerNode
+    {
+
+    public:
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a power in the \ref TypeTree.
+      static const bool isPower = true;
+
+      //! Mark this class as a non composite in the \ref TypeTree.
+      static const bool isComposite = false;
+
+      //! The number of children.
+      std::size_t degree() const
+      {
+        return _children.size();
+      }
+
+      //! The maximum number of children.
+      static constexpr std::size_t maxDegree()
+      {
+        return capacity;
+      }
+
+      //! The type tag that describes the node.
+      typedef DynamicPowerNodeTag NodeTag;
+
+      //! The type of each child.
+      typedef T ChildType;
+
+      //! The storage type of each child.
+      typedef std::shared_ptr<T> ChildStorageType;
+
+      //! The const version of the storage type of each child.
+      typedef std::shared_ptr<const T> ChildConstStorageType;
+
+      //! The type used for storing the children.
+      typedef ReservedVector<ChildStorageType,capacity> NodeStorage;
+
+
+      //! @name Child Access (Dynamic methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      ChildType& child (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      const ChildType& child (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns the storage of the i-th child.
+      /**
+       * \returns a copy of the object storing the i-th child.
+       */
+      ChildStorageType childStorage (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Returns the storage of the i-th child (const version).
+      /**
+       * \returns a copy of the object storing the i-th child.
+       */
+      ChildConstStorageType childStorage (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      const ChildStorageType& childStorageRef (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Sets the i-th child to the passed-in value.
+      void setChild (std::size_t i, ChildType& t)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = stackobject_to_shared_ptr(t);
+      }
+
+      //! Store the passed value in i-th child.
+      void setChild (std::size_t i, ChildType&& t)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = convert_arg(std::move(t));
+      }
+
+      //! Sets the stored value representing the i-th child to the passed-in value.
+      void setChild (std::size_t i, ChildStorageType st)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::move(st);
+      }
+
+      const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Constructors
+      //! @{
+
+    protected:
+
+      //! The Default constructor is deleted, since you need to pass the number of children.
+      BoundedDynamicPowerNode () = delete;
+
+      //! Construct a node with the given number of children.
+      /**
+       * \warning When using this constructor, make sure to set ALL children
+       * by means of the setChild() methods!
+       *
+       * \throws Dune::RangeError if size exceeds the capacity.
+       */
+      explicit BoundedDynamicPowerNode (std::size_t size)
+        : _children(checkedSize(size))
+      {}
+
+      //! Initialize the BoundedDynamicPowerNode with a copy of the passed-in storage type.
+      explicit BoundedDynamicPowerNode (NodeStorage children)
+        : _children(std::move(children))
+      {}
+
+#ifdef DOXYGEN
+
+      //! Initialize all children with the passed-in objects.
+      BoundedDynamicPowerNode (T& t1, T& t2, ...)
+      {}
+
+#else
+
+      template<typename... Children,
+        std::enable_if_t<(std::is_same_v<ChildType, std::decay_t<Children>> &&...), bool> = true>
+      BoundedDynamicPowerNode (Children&&... children)
+      {
+        static_assert(sizeof...(Children) <= capacity, "Number of children exceeds the capacity of BoundedDynamicPowerNode");
+        (_children.push_back(convert_arg(std::forward<Children>(children))),...);
+      }
+
+      template<typename... Children,
+        std::enable_if_t<(std::is_same_v<ChildType, std::decay_t<Children>> &&...), bool> = true>
+      BoundedDynamicPowerNode (std::shared_ptr<Children>... children)
+      {
+        static_assert(sizeof...(Children) <= capacity, "Number of children exceeds the capacity of BoundedDynamicPowerNode");
+        (_children.push_back(std::move(children)),...);
+      }
+
+#endif // DOXYGEN
+
+      //! @}
+
+    private:
+
+      static std::size_t checkedSize (std::size_t size)
+      {
+        if (size > capacity)
+          DUNE_THROW(RangeError, "BoundedDynamicPowerNode with capacity " << capacity
+                     << " cannot store " << size << " children");
+        return size;
+      }
+
+      NodeStorage _children;
+    };
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_BOUNDEDDYNAMICPOWERNODE_HH
@@ -43,46 +43,94 @@ namespace Dune {
         return {};
       }
 
-      template<class NodePtr>
-      auto childStorageImpl (NodePtr&& nodePtr)
+      // Walk down the tree by reference and only access the storage of the final child.
+      // This avoids creating (and destroying) a shared_ptr for every intermediate node.
+      template<class Node, class Storage, class I0, class... I>
+      decltype(auto) childStorageImpl (Node& node, Storage&& storage, I0 i0, [[maybe_unused]] I... i)
       {
-        return std::forward<NodePtr>(nodePtr);
-      }
-
-      // recursively call `node.childStorage(...)` with the given indices
-      template<class NodePtr, class I0, class... I>
-      decltype(auto) childStorageImpl (NodePtr&& nodePtr, I0 i0, [[maybe_unused]] I... i)
-      {
-        auto valid = checkChildIndex(*nodePtr,i0);
+        auto valid = checkChildIndex(node,i0);
         if constexpr (valid)
-          return childStorageImpl(nodePtr->childStorage(i0),i...);
+        {
+          if constexpr (sizeof...(I) > 0)
+            return childStorageImpl(node.child(i0),std::forward<Storage>(storage),i...);
+          else
+            return storage(node,i0);
+        }
         else
           return;
       }
 
       // forward to the impl methods by extracting the indices from the treepath
-      template<class NodePtr, class... Indices, std::size_t... i>
-      decltype(auto) childStorage (NodePtr&& nodePtr, [[maybe_unused]] HybridTreePath<Indices...> tp, std::index_sequence<i...>)
+      template<class Node, class Storage, class... Indices, std::size_t... i>
+      decltype(auto) childStorage (Node& node, Storage&& storage, [[maybe_unused]] HybridTreePath<Indices...> tp, std::index_sequence<i...>)
       {
-        return childStorageImpl(std::forward<NodePtr>(nodePtr),treePathEntry<i>(tp)...);
+        return childStorageImpl(node,std::forward<Storage>(storage),treePathEntry<i>(tp)...);
       }
 
+      struct GetChildStorage
+      {
+        template<class Node, class Index>
+        auto operator() (Node& node, Index i) const
+        {
+          return node.childStorage(i);
+        }
+      };
+
+      struct GetChildStorageRef
+      {
+        template<class Node, class Index>
+        decltype(auto) operator() (Node& node, Index i) const
+        {
+          return node.childStorageRef(i);
+        }
+      };
+
     } // end namespace Impl
 
 #endif // DOXYGEN
 
+    //! Extracts the storage of the child of a node given by a sequence of compile-time and run-time indices.
+    /**
+     * The tree is descended by reference, only the storage of the final child is copied.
+     *
+     * \returns a copy of the object storing the requested child.
+     */
     template<typename Node, typename... Indices>
     auto childStorage (Node&& node, Indices... indices)
     {
       static_assert(sizeof...(Indices) > 0, "childStorage() cannot be called with an empty list of child indices");
-      return Impl::childStorageImpl(&node,indices...);
+      return Impl::childStorageImpl(node,Impl::GetChildStorage{},indices...);
     }
 
+    //! Extracts the storage of the child of a node given by a HybridTreePath object.
     template<typename Node, typename... Indices>
     auto childStorage (Node&& node, HybridTreePath<Indices...> treePath)
     {
       static_assert(sizeof...(Indices) > 0, "childStorage() cannot be called with an empty TreePath");
-      return Impl::childStorage(&node, treePath, std::index_sequence_for<Indices...>{});
+      return Impl::childStorage(node, Impl::GetChildStorage{}, treePath, std::index_sequence_for<Indices...>{});
+    }
+
+    //! Returns a reference to the storage of the child of a node given by a sequence of compile-time and run-time indices.
+    /**
+     * In contrast to childStorage(), this function does not copy any storage object and thus
+     * avoids all reference count updates. It requires the parent of the requested child to
+     * provide a member function `childStorageRef()`.
+     *
+     * \returns a const reference to the object storing the requested child.
+     */
+    template<typename Node, typename... Indices>
+    decltype(auto) childStorageRef (Node&& node, Indices... indices)
+    {
+      static_assert(sizeof...(Indices) > 0, "childStorageRef() cannot be called with an empty list of child indices");
+      return Impl::childStorageImpl(node,Impl::GetChildStorageRef{},indices...);
+    }
+
+    //! Returns a reference to the storage of the child of a node given by a HybridTreePath object.
+    template<typename Node, typename... Indices>
+    decltype(auto) childStorageRef (Node&& node, HybridTreePath<Indices...> treePath)
+    {
+      static_assert(sizeof...(Indices) > 0, "childStorageRef() cannot be called with an empty TreePath");
+      return Impl::childStorage(node, Impl::GetChildStorageRef{}, treePath, std::index_sequence_for<Indices...>{});
     }
 
 #ifndef DOXYGEN
@@ -108,6 +108,20 @@ namespace Dune {
         return std::get<k>(_children);
       }
 
+      //! Returns a reference to the storage of the k-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the k-th child.
+       */
+      template<std::size_t k>
+      const std::shared_ptr<typename Child<k>::Type>& childStorageRef (index_constant<k> = {})
+      {
+        return std::get<k>(_children);
+      }
+
       //! Sets the k-th child to the passed-in value.
       template<std::size_t k>
       void setChild (typename Child<k>::Type& child, index_constant<k> = {})
@@ -113,6 +113,20 @@ namespace Dune {
         return _children[i];
       }
 
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      const ChildStorageType& childStorageRef (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
       //! Sets the i-th child to the passed-in value.
       void setChild (std::size_t i, ChildType& t)
       {
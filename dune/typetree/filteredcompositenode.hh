@@ -74,6 +74,10 @@ namespace Dune {
       };
 
     } // anonymous namespace
+
+    namespace Impl {
+      struct WrappedNodeAccess;
+    }
 #endif // DOXYGEN
 
 
@@ -94,6 +98,9 @@ namespace Dune {
         static const bool value = !nodeIsConst;
       };
 
+      // memoryFootprint() needs to follow the storage of the unfiltered node
+      friend struct Impl::WrappedNodeAccess;
+
     public:
 
       //! The type tag that describes a CompositeNode.
@@ -183,6 +190,21 @@ namespace Dune {
         return _node->template childStorage<Child<k>::mapped_index>();
       }
 
+      //! Returns a reference to the storage of the k-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the k-th child.
+       */
+      template<std::size_t k,
+        typename std::enable_if<lazy_enable<k>::value, int>::type = 0>
+      const auto& childStorageRef (index_constant<k> = {})
+      {
+        return _node->template childStorageRef<Child<k>::mapped_index>();
+      }
+
       //! Sets the k-th child to the passed-in value.
       template<std::size_t k, class ChildType>
       void setChild (ChildType&& child, typename std::enable_if<lazy_enable<k>::value,void*>::type = 0)
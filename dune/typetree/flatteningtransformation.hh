@@ -0,0 +1,249 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_FLATTENINGTRANSFORMATION_HH
+#define DUNE_TYPETREE_FLATTENINGTRANSFORMATION_HH
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/nodeinterface.hh>
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/memoryresource.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+#include <dune/typetree/treepath.hh>
+
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Transformation
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // Checks whether the children of a power node are power nodes with a static degree, which
+      // can be flattened into a single power node with a static degree.
+      template<typename Node>
+      concept FlattenableStaticPowerNode = Node::ChildType::isPower
+        and requires { StaticDegree<typename Node::ChildType>::value; };
+
+      // Checks whether the children of a power node are power nodes.
+      template<typename Node>
+      concept FlattenablePowerNode = Node::ChildType::isPower;
+
+      template<typename SourceNode, typename Transformation, template<typename Child, std::size_t> class TransformedNode>
+      struct FlatteningPowerNodeTransformation
+      {
+
+        static const bool recursive = false;
+
+        typedef typename SourceNode::ChildType InnerNode;
+
+        static const std::size_t outerDegree = StaticDegree<SourceNode>::value;
+        static const std::size_t innerDegree = StaticDegree<InnerNode>::value;
+
+        typedef TransformedNode<typename InnerNode::ChildType, outerDegree * innerDegree> transformed_type;
+        typedef std::shared_ptr<transformed_type> transformed_storage_type;
+
+        static transformed_type transform(const SourceNode& s, const Transformation& t)
+        {
+          return transformed_type(flatChildren(s));
+        }
+
+        static transformed_type transform(std::shared_ptr<const SourceNode> s, const Transformation& t)
+        {
+          return transformed_type(flatChildren(*s));
+        }
+
+        static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
+        {
+          return makeNodeStorage<transformed_type>(t,flatChildren(*s));
+        }
+
+      private:
+
+        static typename transformed_type::NodeStorage flatChildren(const SourceNode& s)
+        {
+          typename transformed_type::NodeStorage children;
+          for (std::size_t i = 0; i < outerDegree; ++i)
+            for (std::size_t j = 0; j < innerDegree; ++j)
+              children[i*innerDegree + j] = std::const_pointer_cast<typename InnerNode::ChildType>(s.child(i).childStorage(j));
+          return children;
+        }
+
+      };
+
+      template<typename SourceNode, typename Transformation, template<typename Child> class TransformedNode>
+      struct FlatteningDynamicPowerNodeTransformation
+      {
+
+        static const bool recursive = false;
+
+        typedef typename SourceNode::ChildType InnerNode;
+
+        typedef TransformedNode<typename InnerNode::ChildType> transformed_type;
+        typedef std::shared_ptr<transformed_type> transformed_storage_type;
+
+        static transformed_type transform(const SourceNode& s, const Transformation& t)
+        {
+          return transformed_type(flatChildren(s));
+        }
+
+        static transformed_type transform(std::shared_ptr<const SourceNode> s, const Transformation& t)
+        {
+          return transformed_type(flatChildren(*s));
+        }
+
+        static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
+        {
+          return makeNodeStorage<transformed_type>(t,flatChildren(*s));
+        }
+
+      private:
+
+        static typename transformed_type::NodeStorage flatChildren(const SourceNode& s)
+        {
+          const std::size_t innerDegree = s.degree() > 0 ? s.child(0).degree() : 0;
+          typename transformed_type::NodeStorage children;
+          children.reserve(s.degree() * innerDegree);
+          for (std::size_t i = 0; i < s.degree(); ++i)
+          {
+            if (s.child(i).degree() != innerDegree)
+              DUNE_THROW(RangeError, "Cannot flatten power node: child " << i << " has degree "
+                         << s.child(i).degree() << ", but child 0 has degree " << innerDegree);
+            for (std::size_t j = 0; j < innerDegree; ++j)
+              children.push_back(std::const_pointer_cast<typename InnerNode::ChildType>(s.child(i).childStorage(j)));
+          }
+          return children;
+        }
+
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Transformation descriptor that flattens a power node of power nodes into a single power node.
+    /**
+     * The descriptor maps a node of type `PowerNode<PowerNode<T,a>,b>` to a node of type
+     * `TransformedNode<T,a*b>`. The child with index `i*a+j` of the flattened node is the child `j`
+     * of the child `i` of the source node. The flattened node shares these grandchildren with the
+     * source tree, so changes to the leaves are visible in both trees. The flattened node grants
+     * mutable access to the grandchildren even if the source tree is const. Use flatTreePath() and
+     * nestedTreePath() to map tree paths between the two trees.
+     *
+     * The descriptor is not recursive, i.e. the grandchildren are not transformed. Power nodes whose
+     * children are not power nodes with a static degree, e.g. a power node of leaves next to a
+     * nested power node in a composite node, are left unchanged as by IdentityNodeTransformation.
+     */
+    template<typename SourceNode, typename Transformation, template<typename Child, std::size_t> class TransformedNode>
+    struct FlatteningPowerNodeTransformation
+      : public std::conditional_t<Impl::FlattenableStaticPowerNode<SourceNode>,
+                                  Impl::FlatteningPowerNodeTransformation<SourceNode,Transformation,TransformedNode>,
+                                  IdentityNodeTransformation<SourceNode,Transformation>>
+    {};
+
+
+    //! Transformation descriptor that flattens a dynamic power node of dynamic power nodes into a single dynamic power node.
+    /**
+     * The descriptor maps a node of type `DynamicPowerNode<DynamicPowerNode<T>>` with `b` children
+     * of degree `a` each to a node of type `TransformedNode<T>` with `a*b` children. The child with
+     * index `i*a+j` of the flattened node is the child `j` of the child `i` of the source node, and
+     * the flattened node shares these grandchildren with the source tree, including mutable access
+     * to them. Dynamic power nodes whose children are not power nodes are left unchanged as by
+     * IdentityNodeTransformation.
+     *
+     * \throws Dune::RangeError if the children of the source node do not all have the same degree.
+     */
+    template<typename SourceNode, typename Transformation, template<typename Child> class TransformedNode>
+    struct FlatteningDynamicPowerNodeTransformation
+      : public std::conditional_t<Impl::FlattenablePowerNode<SourceNode>,
+                                  Impl::FlatteningDynamicPowerNodeTransformation<SourceNode,Transformation,TransformedNode>,
+                                  IdentityNodeTransformation<SourceNode,Transformation>>
+    {};
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // Computes i*n+j, returning an index_constant if all arguments are static.
+      template<typename I, typename N, typename J>
+      constexpr auto flatIndex (I i, N n, J j)
+      {
+        if constexpr (IsIntegralConstant<I>::value and IsIntegralConstant<N>::value and IsIntegralConstant<J>::value)
+          return index_constant<I::value * N::value + J::value>{};
+        else
+          return std::size_t(i) * std::size_t(n) + std::size_t(j);
+      }
+
+      // Computes (i/n,i%n), returning index_constants if all arguments are static.
+      template<typename I, typename N>
+      constexpr auto nestedIndices (I i, N n)
+      {
+        if constexpr (IsIntegralConstant<I>::value and IsIntegralConstant<N>::value)
+          return std::make_pair(index_constant<I::value / N::value>{},index_constant<I::value % N::value>{});
+        else
+          return std::make_pair(std::size_t(i) / std::size_t(n),std::size_t(i) % std::size_t(n));
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Maps a tree path in a nested power node to the corresponding tree path in the flattened node.
+    /**
+     * The tree path `(i,j,rest...)` in the nested node is mapped to `(i*innerDegree+j,rest...)`.
+     * The resulting first index is static if `i`, `j` and `innerDegree` are all static.
+     *
+     * \param treePath     A tree path of length at least 2, relative to the nested power node.
+     * \param innerDegree  The degree of the children of the nested node, either as a std::size_t
+     *                     or as an index_constant.
+     * \sa FlatteningPowerNodeTransformation, nestedTreePath()
+     */
+    template<typename... T, typename N>
+    constexpr auto flatTreePath (const HybridTreePath<T...>& treePath, N innerDegree)
+    {
+      static_assert(sizeof...(T) >= 2, "flatTreePath() requires a tree path of length at least 2");
+      auto rest = pop_front(pop_front(treePath));
+      return push_front(rest,Impl::flatIndex(treePath[Indices::_0],innerDegree,treePath[Indices::_1]));
+    }
+
+    //! Maps a tree path in a flattened power node to the corresponding tree path in the nested node.
+    /**
+     * The tree path `(k,rest...)` in the flattened node is mapped to
+     * `(k/innerDegree,k%innerDegree,rest...)`. This is the inverse of flatTreePath().
+     *
+     * \param treePath     A non-empty tree path relative to the flattened power node.
+     * \param innerDegree  The degree of the children of the nested node, either as a std::size_t
+     *                     or as an index_constant.
+     * \sa FlatteningPowerNodeTransformation, flatTreePath()
+     */
+    template<typename... T, typename N>
+    constexpr auto nestedTreePath (const HybridTreePath<T...>& treePath, N innerDegree)
+    {
+      static_assert(sizeof...(T) >= 1, "nestedTreePath() requires a non-empty tree path");
+      auto [i,j] = Impl::nestedIndices(treePath[Indices::_0],innerDegree);
+      return push_front(push_front(pop_front(treePath),j),i);
+    }
+
+    //! \} group Transformation
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_FLATTENINGTRANSFORMATION_HH
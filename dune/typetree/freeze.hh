@@ -0,0 +1,256 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_FREEZE_HH
+#define DUNE_TYPETREE_FREEZE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/rangeutilities.hh>
+
+#include <dune/typetree/nodeinterface.hh>
+#include <dune/typetree/nodetags.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // Bump allocator for the nodes of a frozen tree. A probing arena without a buffer instead
+      // records the requests and forwards them to operator new, which is used to find out how much
+      // memory std::allocate_shared() actually requests for a node type.
+      class FreezeArena
+      {
+
+      public:
+
+        // The alignment of the buffer. Requests with a larger alignment are not served from it.
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+        struct Request
+        {
+          std::size_t bytes;
+          std::size_t align;
+        };
+
+        // Creates a probing arena.
+        FreezeArena () = default;
+
+        // Creates an arena with a buffer of the given size.
+        explicit FreezeArena (std::size_t size)
+          : _buffer(static_cast<std::byte*>(::operator new(size,std::align_val_t(alignment))))
+          , _capacity(size)
+        {}
+
+        FreezeArena (const FreezeArena&) = delete;
+        FreezeArena& operator= (const FreezeArena&) = delete;
+
+        ~FreezeArena ()
+        {
+          if (_buffer)
+            ::operator delete(_buffer,std::align_val_t(alignment));
+        }
+
+        // Adds a request to a buffer of size bytes, returns the new size of the buffer.
+        static std::size_t append (std::size_t size, const Request& request)
+        {
+          if (request.align > alignment)
+            return size;
+          return (size + request.align - 1) / request.align * request.align + request.bytes;
+        }
+
+        void* allocate (std::size_t bytes, std::size_t align)
+        {
+          if (not _buffer)
+            _requests.push_back({bytes,align});
+          else if (align <= alignment) {
+            std::size_t used = append(_used,{bytes,align});
+            if (used <= _capacity) {
+              void* p = _buffer + (used - bytes);
+              _used = used;
+              return p;
+            }
+          }
+          return ::operator new(bytes,std::align_val_t(align));
+        }
+
+        void deallocate (void* p, std::size_t bytes, std::size_t align)
+        {
+          // memory in the buffer is released with the arena
+          std::less<const void*> less;
+          if (not _buffer or less(p,_buffer) or not less(p,_buffer + _capacity))
+            ::operator delete(p,bytes,std::align_val_t(align));
+        }
+
+        // The requests recorded by a probing arena.
+        const std::vector<Request>& requests () const
+        {
+          return _requests;
+        }
+
+        // The number of bytes of the buffer that have been handed out.
+        std::size_t used () const
+        {
+          return _used;
+        }
+
+      private:
+        std::byte* _buffer = nullptr;
+        std::size_t _capacity = 0;
+        std::size_t _used = 0;
+        std::vector<Request> _requests;
+      };
+
+      // Allocator that allocates from a shared FreezeArena. Every control block created by
+      // std::allocate_shared() stores a copy of the allocator, so the arena is released together
+      // with the last node of the frozen tree.
+      template<typename T>
+      class FreezeArenaAllocator
+      {
+
+        template<typename>
+        friend class FreezeArenaAllocator;
+
+      public:
+
+        using value_type = T;
+
+        explicit FreezeArenaAllocator (std::shared_ptr<FreezeArena> arena)
+          : _arena(std::move(arena))
+        {}
+
+        template<typename U>
+        FreezeArenaAllocator (const FreezeArenaAllocator<U>& other)
+          : _arena(other._arena)
+        {}
+
+        T* allocate (std::size_t n)
+        {
+          return static_cast<T*>(_arena->allocate(n*sizeof(T),alignof(T)));
+        }
+
+        void deallocate (T* p, std::size_t n)
+        {
+          _arena->deallocate(p,n*sizeof(T),alignof(T));
+        }
+
+        template<typename U>
+        bool operator== (const FreezeArenaAllocator<U>& other) const
+        {
+          return _arena == other._arena;
+        }
+
+        template<typename U>
+        bool operator!= (const FreezeArenaAllocator<U>& other) const
+        {
+          return _arena != other._arena;
+        }
+
+      private:
+        std::shared_ptr<FreezeArena> _arena;
+      };
+
+      // The requests that std::allocate_shared() makes for a copy of a node of type Node, including
+      // the control block with the embedded allocator. They only depend on the type, so they are
+      // recorded once by copying the first node of each type into a probing arena.
+      template<typename Node>
+      const std::vector<FreezeArena::Request>& frozenNodeRequests (const Node& node)
+      {
+        static const std::vector<FreezeArena::Request> requests = [&]{
+          auto probe = std::make_shared<FreezeArena>();
+          std::allocate_shared<Node>(FreezeArenaAllocator<Node>(probe),node);
+          return probe->requests();
+        }();
+        return requests;
+      }
+
+      // Adds the requests for freezing the subtree rooted in node to a buffer of the given size,
+      // in the order in which freezeNode() makes them.
+      template<typename Node>
+      std::size_t frozenTreeSize (const Node& node, std::size_t size = 0)
+      {
+        for (const auto& request : frozenNodeRequests(node))
+          size = FreezeArena::append(size,request);
+        if constexpr (not Node::isLeaf)
+          Hybrid::forEach(Dune::range(node.degree()), [&](auto i) {
+            size = frozenTreeSize(node.child(i),size);
+          });
+        return size;
+      }
+
+      // Copies node into the arena and then recursively replaces its children by frozen copies.
+      // Nodes are thus allocated in depth-first pre-order, which is the order in which applyToTree()
+      // visits them.
+      template<typename Node>
+      std::shared_ptr<Node> freezeNode (const Node& node, const FreezeArenaAllocator<Node>& allocator)
+      {
+        auto frozen = std::allocate_shared<Node>(allocator,node);
+        if constexpr (not Node::isLeaf)
+          Hybrid::forEach(Dune::range(frozen->degree()), [&](auto i) {
+            using Child = std::decay_t<decltype(node.child(i))>;
+            auto child = freezeNode(node.child(i),FreezeArenaAllocator<Child>(allocator));
+            if constexpr (std::is_same_v<NodeTag<Node>,DynamicPowerNodeTag>)
+              frozen->setChild(i,std::move(child));
+            else
+              frozen->setChild(std::move(child),i);
+          });
+        return frozen;
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Creates an immutable deep copy of a tree that is laid out contiguously in memory.
+    /**
+     * All nodes of the copy are allocated from a single buffer in depth-first pre-order, i.e.,
+     * in the order in which applyToTree() visits them. Traversing the frozen tree thus accesses
+     * memory linearly instead of following pointers to nodes scattered across the heap. The buffer
+     * is released when the last node of the frozen tree is destroyed, and the frozen tree does not
+     * share any nodes with the original tree.
+     *
+     * The buffer is sized from the memory that `std::allocate_shared()` actually requests for each
+     * node, including its control block. The requests are recorded once per node type by copying
+     * the first node of that type with a probing allocator.
+     *
+     * The nodes of the copy have the same types as the original nodes. Every node must be
+     * copy constructible, and the copy constructor of inner nodes must copy the storage of the
+     * children, which is then replaced by means of setChild(). This holds for all nodes derived
+     * from PowerNode, DynamicPowerNode and CompositeNode. Memory that a node allocates itself,
+     * like the storage of the child pointers of a DynamicPowerNode, is not moved into the buffer.
+     *
+     * \param tree  The tree to freeze.
+     * \returns     A shared_ptr to the const root node of the frozen tree.
+     */
+    template<typename Tree>
+    std::shared_ptr<const Tree> freeze (const Tree& tree)
+    {
+      const std::size_t size = Impl::frozenTreeSize(tree);
+      auto arena = std::make_shared<Impl::FreezeArena>(size);
+      auto frozen = Impl::freezeNode(tree,Impl::FreezeArenaAllocator<Tree>(arena));
+      assert(arena->used() == size && "freeze() did not fill the buffer exactly");
+      return frozen;
+    }
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_FREEZE_HH
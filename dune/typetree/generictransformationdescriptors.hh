@@ -8,10 +8,12 @@
 
 #include <array>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <dune/typetree/nodeinterface.hh>
 #include <dune/typetree/nodetags.hh>
+#include <dune/typetree/memoryresource.hh>
 #include <dune/typetree/powercompositenodetransformationtemplates.hh>
 #include <dune/common/exceptions.hh>
 
@@ -40,12 +42,12 @@ namespace Dune {
 
       static transformed_type transform(std::shared_ptr<const SourceNode> s, const Transformation& t)
       {
-        return transformed_type(s,t);
+        return transformed_type(std::move(s),t);
       }
 
       static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
       {
-        return std::make_shared<transformed_type>(s,t);
+        return makeNodeStorage<transformed_type>(t,std::move(s),t);
       }
 
     };
@@ -74,13 +76,13 @@ namespace Dune {
       template<typename TC>
       static typename result<TC>::type transform(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::array<std::shared_ptr<TC>,result<TC>::degree>& children)
       {
-        return typename result<TC>::type(s,t,children);
+        return typename result<TC>::type(std::move(s),t,children);
       }
 
       template<typename TC>
       static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::array<std::shared_ptr<TC>,result<TC>::degree>& children)
       {
-        return std::make_shared<typename result<TC>::type>(s,t,children);
+        return makeNodeStorage<typename result<TC>::type>(t,std::move(s),t,children);
       }
 
     };
@@ -119,13 +121,13 @@ namespace Dune {
       template<typename TC>
       static typename result<TC>::type transform(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::vector<std::shared_ptr<TC>>& children)
       {
-        return typename result<TC>::type(s,t,children);
+        return typename result<TC>::type(std::move(s),t,children);
       }
 
       template<typename TC>
       static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::vector<std::shared_ptr<TC>>& children)
       {
-        return std::make_shared<typename result<TC>::type>(s,t,children);
+        return makeNodeStorage<typename result<TC>::type>(t,std::move(s),t,children);
       }
 
     };
@@ -164,13 +166,13 @@ namespace Dune {
       template<typename... TC>
       static typename result<TC...>::type transform(std::shared_ptr<const SourceNode> s, const Transformation& t, std::shared_ptr<TC>... children)
       {
-        return typename result<TC...>::type(s,t,children...);
+        return typename result<TC...>::type(std::move(s),t,std::move(children)...);
       }
 
       template<typename... TC>
       static typename result<TC...>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, std::shared_ptr<TC>... children)
       {
-        return std::make_shared<typename result<TC...>::type>(s,t,children...);
+        return makeNodeStorage<typename result<TC...>::type>(t,std::move(s),t,std::move(children)...);
       }
 
     };
@@ -54,7 +54,7 @@ namespace Dune {
        * class that needs to be filled with meaning by subclassing it
        * and adding useful functionality to the subclass.
        */
-      LeafNode() {}
+      constexpr LeafNode() {}
     };
 
     //! \} group Nodes
@@ -0,0 +1,594 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_LEAFRANGE_HH
+#define DUNE_TYPETREE_LEAFRANGE_HH
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<coroutine>)
+#include <coroutine>
+#endif
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/typetree/nodeconcepts.hh>
+
+#include <dune/typetree/treepath.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // The type of the nodes on level k below Node, following the children with run-time indices.
+      template<class Node, std::size_t k>
+      struct UniformLevelNode
+      {
+        using type = typename UniformLevelNode<std::remove_reference_t<decltype(std::declval<Node&>().child(0u))>,k-1>::type;
+      };
+
+      template<class Node>
+      struct UniformLevelNode<Node,0>
+      {
+        using type = Node;
+      };
+
+      // The depth of the leaves below Node, or -1 if Node does not have a uniform leaf type.
+      template<class Node>
+      constexpr int uniformLeafDepth ()
+      {
+        if constexpr (Concept::LeafTreeNode<Node>)
+          return 0;
+        else if constexpr (Concept::UniformInnerTreeNode<Node>) {
+          constexpr int depth = uniformLeafDepth<typename UniformLevelNode<Node,1>::type>();
+          return depth < 0 ? -1 : depth + 1;
+        }
+        else
+          return -1;
+      }
+
+      // Checks whether all inner nodes of the uniform tree Node have a static degree.
+      template<class Node>
+      constexpr bool hasStaticUniformDegrees ()
+      {
+        if constexpr (Concept::LeafTreeNode<Node>)
+          return true;
+        else if constexpr (Concept::StaticDegreeInnerTreeNode<Node>)
+          return hasStaticUniformDegrees<typename UniformLevelNode<Node,1>::type>();
+        else
+          return false;
+      }
+
+      template<std::size_t>
+      using RuntimeIndex = std::size_t;
+
+      template<class Tree, class Levels>
+      struct UniformLevelTypes;
+
+      // The tree path of the leaves and the tuple of node pointers along it.
+      template<class Tree, std::size_t... k>
+      struct UniformLevelTypes<Tree,std::index_sequence<k...>>
+      {
+        using TreePath = HybridTreePath<RuntimeIndex<k>...>;
+        using Nodes = std::tuple<typename UniformLevelNode<Tree,k>::type*...,
+                                 typename UniformLevelNode<Tree,sizeof...(k)>::type*>;
+      };
+
+      template<class Tree>
+      using UniformLeafTreePath = typename UniformLevelTypes<Tree,std::make_index_sequence<uniformLeafDepth<Tree>()>>::TreePath;
+
+      // Iterator over the leaves of a uniform tree in which all nodes have a static degree.
+      // The position is the index of the leaf in depth-first order, which is mapped to the
+      // tree path on dereferencing.
+      template<class Tree>
+      class StaticLeafIterator
+      {
+        static constexpr std::size_t depth = uniformLeafDepth<Tree>();
+
+        template<std::size_t k>
+        using Node = typename UniformLevelNode<Tree,k>::type;
+
+        // The number of leaves below a node on level k.
+        template<std::size_t k>
+        static constexpr std::size_t leafCount ()
+        {
+          if constexpr (k == depth)
+            return 1;
+          else
+            return Node<k>::degree() * leafCount<k+1>();
+        }
+
+        template<std::size_t k>
+        Node<depth>& leaf (Node<k>& node, std::array<std::size_t,depth>& path) const
+        {
+          if constexpr (k == depth)
+            return node;
+          else {
+            path[k] = (_position / leafCount<k+1>()) % Node<k>::degree();
+            return leaf<k+1>(node.child(path[k]),path);
+          }
+        }
+
+      public:
+
+        using TreePath = UniformLeafTreePath<Tree>;
+        using value_type = std::pair<Node<depth>&,TreePath>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        static constexpr std::size_t size ()
+        {
+          return leafCount<0>();
+        }
+
+        StaticLeafIterator () = default;
+
+        StaticLeafIterator (Tree* tree, difference_type position)
+          : _tree(tree)
+          , _position(position)
+        {}
+
+        reference operator* () const
+        {
+          std::array<std::size_t,depth> path;
+          auto& l = leaf<0>(*_tree,path);
+          return reference(l,unpackIntegerSequence([&](auto... k) {
+              return hybridTreePath(path[k]...);
+            }, std::make_index_sequence<depth>()));
+        }
+
+        reference operator[] (difference_type n) const
+        {
+          return *(*this + n);
+        }
+
+        StaticLeafIterator& operator++ () { ++_position; return *this; }
+        StaticLeafIterator operator++ (int) { auto tmp = *this; ++_position; return tmp; }
+        StaticLeafIterator& operator-- () { --_position; return *this; }
+        StaticLeafIterator operator-- (int) { auto tmp = *this; --_position; return tmp; }
+        StaticLeafIterator& operator+= (difference_type n) { _position += n; return *this; }
+        StaticLeafIterator& operator-= (difference_type n) { _position -= n; return *this; }
+
+        friend StaticLeafIterator operator+ (StaticLeafIterator it, difference_type n) { return it += n; }
+        friend StaticLeafIterator operator+ (difference_type n, StaticLeafIterator it) { return it += n; }
+        friend StaticLeafIterator operator- (StaticLeafIterator it, difference_type n) { return it -= n; }
+
+        friend difference_type operator- (const StaticLeafIterator& a, const StaticLeafIterator& b)
+        {
+          return a._position - b._position;
+        }
+
+        friend bool operator== (const StaticLeafIterator& a, const StaticLeafIterator& b)
+        {
+          return a._position == b._position;
+        }
+
+        friend std::strong_ordering operator<=> (const StaticLeafIterator& a, const StaticLeafIterator& b)
+        {
+          return a._position <=> b._position;
+        }
+
+      private:
+        Tree* _tree = nullptr;
+        difference_type _position = 0;
+      };
+
+      // Forward iterator over the leaves of a uniform tree with dynamic degrees.
+      // It stores the node and the child index on every level of the current path.
+      template<class Tree>
+      class DynamicLeafIterator
+      {
+        static constexpr std::size_t depth = uniformLeafDepth<Tree>();
+
+        template<std::size_t k>
+        using Node = typename UniformLevelNode<Tree,k>::type;
+
+        using Nodes = typename UniformLevelTypes<Tree,std::make_index_sequence<depth>>::Nodes;
+
+        // Moves to the first leaf in the subtree of the node on level k,
+        // starting with the child _path[k]. Returns false if there is none.
+        template<std::size_t k>
+        bool seek ()
+        {
+          if constexpr (k == depth)
+            return true;
+          else {
+            auto& node = *std::get<k>(_nodes);
+            for (; _path[k] < std::size_t(node.degree()); ++_path[k]) {
+              std::get<k+1>(_nodes) = &node.child(_path[k]);
+              if constexpr (k+1 < depth)
+                _path[k+1] = 0;
+              if (seek<k+1>())
+                return true;
+            }
+            return false;
+          }
+        }
+
+        // Moves to the next leaf in the subtree of the node on level k.
+        // Returns false if the current leaf was the last one.
+        template<std::size_t k>
+        bool increment ()
+        {
+          if constexpr (k == depth)
+            return false;
+          else {
+            if (increment<k+1>())
+              return true;
+            ++_path[k];
+            return seek<k>();
+          }
+        }
+
+      public:
+
+        using TreePath = UniformLeafTreePath<Tree>;
+        using value_type = std::pair<Node<depth>&,TreePath>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        DynamicLeafIterator () = default;
+
+        explicit DynamicLeafIterator (Tree* tree)
+          : _end(false)
+        {
+          std::get<0>(_nodes) = tree;
+          _path.fill(0);
+          _end = not seek<0>();
+        }
+
+        reference operator* () const
+        {
+          return reference(*std::get<depth>(_nodes),unpackIntegerSequence([&](auto... k) {
+              return hybridTreePath(_path[k]...);
+            }, std::make_index_sequence<depth>()));
+        }
+
+        DynamicLeafIterator& operator++ ()
+        {
+          _end = not increment<0>();
+          return *this;
+        }
+
+        DynamicLeafIterator operator++ (int)
+        {
+          auto tmp = *this;
+          ++(*this);
+          return tmp;
+        }
+
+        friend bool operator== (const DynamicLeafIterator& a, const DynamicLeafIterator& b)
+        {
+          if (a._end or b._end)
+            return a._end == b._end;
+          return a._path == b._path and std::get<0>(a._nodes) == std::get<0>(b._nodes);
+        }
+
+        friend bool operator== (const DynamicLeafIterator& it, std::default_sentinel_t)
+        {
+          return it._end;
+        }
+
+      private:
+        Nodes _nodes = {};
+        std::array<std::size_t,depth> _path = {};
+        bool _end = true;
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Checks whether all leaves of Tree have the same type.
+    /**
+     * This is the case if all inner nodes of the tree have children of a single type that can
+     * be accessed with run-time indices, e.g. for trees built from PowerNode and DynamicPowerNode.
+     * All leaves of such a tree have the same depth.
+     */
+    template<class Tree>
+    concept UniformLeafTree = Concept::TreeNode<Tree> and (Impl::uniformLeafDepth<std::remove_reference_t<Tree>>() >= 0);
+
+    //! A lazy range over the leaves of a tree with a uniform leaf type.
+    /**
+     * The elements of the range are pairs of a reference to the leaf and its tree path, which
+     * has a run-time index on every level. The leaves are enumerated in the same order as by
+     * forEachLeafNode(). If all inner nodes have a static degree, the range is a sized random
+     * access range, otherwise it is a forward range that skips empty subtrees on the fly.
+     *
+     * The range only stores a pointer to the tree and can thus be used with the range adaptors
+     * of the standard library. It must not outlive the tree.
+     *
+     * \tparam Tree  The type of the tree, including a possible const qualifier.
+     */
+    template<UniformLeafTree Tree>
+    class LeafRange
+      : public std::ranges::view_interface<LeafRange<Tree>>
+    {
+
+      static constexpr bool isStatic = Impl::hasStaticUniformDegrees<Tree>();
+
+    public:
+
+      //! The iterator type of the range.
+      using iterator = std::conditional_t<isStatic,
+                                          Impl::StaticLeafIterator<Tree>,
+                                          Impl::DynamicLeafIterator<Tree>>;
+
+      //! The type of the leaves.
+      using Leaf = typename Impl::UniformLevelNode<Tree,Impl::uniformLeafDepth<Tree>()>::type;
+
+      //! The type of the tree paths of the leaves.
+      using TreePath = typename iterator::TreePath;
+
+      LeafRange () = default;
+
+      //! Creates a range over the leaves of the given tree.
+      explicit LeafRange (Tree& tree)
+        : _tree(&tree)
+      {}
+
+      //! Returns an iterator to the first leaf.
+      iterator begin () const
+      {
+        if constexpr (isStatic)
+          return iterator(_tree,0);
+        else
+          return iterator(_tree);
+      }
+
+      //! Returns the end of the range.
+      auto end () const
+      {
+        if constexpr (isStatic)
+          return iterator(_tree,iterator::size());
+        else
+          return std::default_sentinel;
+      }
+
+      //! Returns the number of leaves, only available if all degrees are static.
+      static constexpr std::size_t size () requires isStatic
+      {
+        return iterator::size();
+      }
+
+    private:
+      Tree* _tree = nullptr;
+    };
+
+    //! Returns a lazy range over the leaves of a tree with a uniform leaf type.
+    /**
+     * \code
+     #include <dune/typetree/leafrange.hh>
+     * \endcode
+     * \sa LeafRange
+     */
+    template<UniformLeafTree Tree>
+    LeafRange<Tree> leafRange (Tree& tree)
+    {
+      return LeafRange<Tree>(tree);
+    }
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+
+    //! A lazily evaluated sequence of values produced by a coroutine.
+    /**
+     * The generator is an input range. Values are produced when the range is iterated, and
+     * iteration may stop at any time. The values are returned as references to objects in the
+     * suspended coroutine, which are valid until the iterator is incremented.
+     *
+     * \tparam T  The type of the generated values.
+     */
+    template<class T>
+    class LeafGenerator
+      : public std::ranges::view_interface<LeafGenerator<T>>
+    {
+
+    public:
+
+      struct promise_type
+      {
+        const T* value = nullptr;
+        std::exception_ptr exception;
+
+        LeafGenerator get_return_object ()
+        {
+          return LeafGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend () noexcept { return {}; }
+        std::suspend_always final_suspend () noexcept { return {}; }
+
+        std::suspend_always yield_value (const T& v) noexcept
+        {
+          value = std::addressof(v);
+          return {};
+        }
+
+        void return_void () noexcept {}
+
+        void unhandled_exception ()
+        {
+          exception = std::current_exception();
+        }
+      };
+
+      using Handle = std::coroutine_handle<promise_type>;
+
+      class iterator
+      {
+        void resume ()
+        {
+          _handle.resume();
+          if (_handle.done() and _handle.promise().exception)
+            std::rethrow_exception(_handle.promise().exception);
+        }
+
+      public:
+
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator () = default;
+
+        explicit iterator (Handle handle)
+          : _handle(handle)
+        {
+          resume();
+        }
+
+        const T& operator* () const
+        {
+          return *_handle.promise().value;
+        }
+
+        iterator& operator++ ()
+        {
+          resume();
+          return *this;
+        }
+
+        void operator++ (int)
+        {
+          ++(*this);
+        }
+
+        friend bool operator== (const iterator& it, std::default_sentinel_t)
+        {
+          return not it._handle or it._handle.done();
+        }
+
+      private:
+        Handle _handle = nullptr;
+      };
+
+      LeafGenerator () = default;
+
+      explicit LeafGenerator (Handle handle)
+        : _handle(handle)
+      {}
+
+      LeafGenerator (LeafGenerator&& other) noexcept
+        : _handle(std::exchange(other._handle,nullptr))
+      {}
+
+      LeafGenerator& operator= (LeafGenerator&& other) noexcept
+      {
+        if (this != &other) {
+          if (_handle)
+            _handle.destroy();
+          _handle = std::exchange(other._handle,nullptr);
+        }
+        return *this;
+      }
+
+      ~LeafGenerator ()
+      {
+        if (_handle)
+          _handle.destroy();
+      }
+
+      //! Starts the coroutine and returns an iterator to the first value.
+      /**
+       * The range can only be iterated once.
+       */
+      iterator begin ()
+      {
+        return iterator(_handle);
+      }
+
+      std::default_sentinel_t end () const
+      {
+        return std::default_sentinel;
+      }
+
+    private:
+      Handle _handle = nullptr;
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<class T, class Node, class TreePath, class F>
+      LeafGenerator<T> leafGenerator (Node& node, TreePath treePath, F& f)
+      {
+        if constexpr (Concept::LeafTreeNode<Node>)
+          co_yield f(node,treePath);
+        else if constexpr (Concept::UniformInnerTreeNode<Node>) {
+          for (std::size_t i = 0; i < std::size_t(node.degree()); ++i)
+            for (const T& value : leafGenerator<T>(node.child(i),push_back(treePath,i),f))
+              co_yield value;
+        }
+        else {
+          // the coroutines of all children are created up front but only run on demand
+          auto children = unpackIntegerSequence([&](auto... i) {
+              return std::array<LeafGenerator<T>,sizeof...(i)>{
+                leafGenerator<T>(node.child(i),push_back(treePath,i),f)...
+              };
+            }, std::make_index_sequence<Node::degree()>());
+          for (auto& child : children)
+            for (const T& value : child)
+              co_yield value;
+        }
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Returns a coroutine generating a value for every leaf of the tree.
+    /**
+     * \code
+     #include <dune/typetree/leafrange.hh>
+     * \endcode
+     * This works for arbitrary trees. Every leaf is passed to `f(leaf, treePath)` in the order of
+     * forEachLeafNode(), and the result is converted to `T` and yielded. The leaves are only visited
+     * as the generator is iterated, so iteration can be paused or stopped early without traversing
+     * the remaining tree. The tree paths contain run-time indices for the children of power nodes.
+     *
+     * The generator uses one coroutine per inner node on the current path, so each value is passed
+     * up through all levels of the tree. For trees with a uniform leaf type, leafRange() is cheaper.
+     * The generator refers to the tree and must not outlive it.
+     *
+     * \tparam T     The type of the generated values.
+     * \param  tree  The tree whose leaves are visited.
+     * \param  f     The function that is applied to every leaf and its tree path.
+     */
+    template<class T, Concept::TreeNode Tree, class F>
+    LeafGenerator<T> leafGenerator (Tree& tree, F f)
+    {
+      for (const T& value : Impl::leafGenerator<T>(tree,hybridTreePath(),f))
+        co_yield value;
+    }
+
+#endif // __cpp_impl_coroutine
+
+    //! \} group Tree Traversal
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_LEAFRANGE_HH
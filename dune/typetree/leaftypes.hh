@@ -0,0 +1,194 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_LEAFTYPES_HH
+#define DUNE_TYPETREE_LEAFTYPES_HH
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/rangeutilities.hh>
+#include <dune/common/typetree/childaccess.hh>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename Tree, typename LeafTreePaths>
+      struct LeafTypeBucketing;
+
+      // Assigns each leaf to the bucket of its type. The buckets are numbered in the order of
+      // the first leaf of each type in depth-first order.
+      template<typename Tree, typename... P>
+      struct LeafTypeBucketing<Tree,std::tuple<P...>>
+      {
+        static constexpr std::size_t leafCount = sizeof...(P);
+
+        template<typename L>
+        static constexpr std::array<bool,leafCount> sameType = {{ std::is_same_v<L,ChildForTreePath<Tree,P>>... }};
+
+        static constexpr std::array<std::array<bool,leafCount>,leafCount> same = {{ sameType<ChildForTreePath<Tree,P>>... }};
+
+        static constexpr auto computeBuckets ()
+        {
+          std::array<std::size_t,leafCount> bucket = {};
+          std::array<std::size_t,leafCount> firstLeaf = {};
+          std::size_t buckets = 0;
+          for (std::size_t i = 0; i < leafCount; ++i)
+          {
+            std::size_t j = 0;
+            while (not same[i][j])
+              ++j;
+            if (j == i)
+              firstLeaf[buckets++] = i;
+            bucket[i] = (j == i) ? buckets-1 : bucket[j];
+          }
+          return std::make_tuple(bucket,firstLeaf,buckets);
+        }
+
+        static constexpr std::array<std::size_t,leafCount> bucket = std::get<0>(computeBuckets());
+        static constexpr std::array<std::size_t,leafCount> firstLeaf = std::get<1>(computeBuckets());
+        static constexpr std::size_t bucketCount = std::get<2>(computeBuckets());
+
+        static constexpr std::size_t count (std::size_t k)
+        {
+          std::size_t n = 0;
+          for (std::size_t i = 0; i < leafCount; ++i)
+            n += (bucket[i] == k);
+          return n;
+        }
+
+        // the indices of the leaves in bucket k in depth-first order
+        template<std::size_t k>
+        static constexpr std::array<std::size_t,count(k)> leaves ()
+        {
+          std::array<std::size_t,count(k)> result = {};
+          std::size_t n = 0;
+          for (std::size_t i = 0; i < leafCount; ++i)
+            if (bucket[i] == k)
+              result[n++] = i;
+          return result;
+        }
+      };
+
+      template<typename Buckets, typename Indices>
+      struct LeafTypeTuple;
+
+      template<typename Buckets, std::size_t... k>
+      struct LeafTypeTuple<Buckets,std::index_sequence<k...>>
+      {
+        using type = std::tuple<typename Buckets::template Type<k>...>;
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! The distinct leaf types of a static tree, with the tree paths of the leaves of each type.
+    /**
+     * \code
+     #include <dune/typetree/leaftypes.hh>
+     * \endcode
+     * The leaves of a tree are grouped into buckets by their type. The buckets are numbered in the
+     * order in which their first leaf appears in a depth-first traversal, and the leaves in each
+     * bucket keep their depth-first order. All information is available at compile time, and no
+     * tree object is required. All nodes of the tree must have a static degree.
+     *
+     * \tparam Tree  The type of the tree.
+     * \sa forEachLeafNodeByType()
+     */
+    template<typename Tree>
+    struct LeafTypeBuckets
+    {
+
+#ifndef DOXYGEN
+
+      using TreePaths = decltype(leafTreePathTuple<Tree,TreePathType::fullyStatic>());
+      using Bucketing = Impl::LeafTypeBucketing<std::decay_t<Tree>,TreePaths>;
+
+#endif // DOXYGEN
+
+      //! The number of distinct leaf types.
+      static constexpr std::size_t size ()
+      {
+        return Bucketing::bucketCount;
+      }
+
+      //! The leaf type of bucket k.
+      template<std::size_t k>
+      using Type = ChildForTreePath<std::decay_t<Tree>,std::tuple_element_t<Bucketing::firstLeaf[k],TreePaths>>;
+
+      //! A std::tuple of all distinct leaf types.
+      using Types = typename Impl::LeafTypeTuple<LeafTypeBuckets,std::make_index_sequence<Bucketing::bucketCount>>::type;
+
+      //! The number of leaves in bucket k.
+      template<std::size_t k>
+      static constexpr std::size_t count (index_constant<k> = {})
+      {
+        return Bucketing::count(k);
+      }
+
+      //! A std::tuple of the static tree paths of the leaves in bucket k.
+      template<std::size_t k>
+      static constexpr auto treePaths (index_constant<k> = {})
+      {
+        return unpackIntegerSequence([](auto... i) {
+            return std::make_tuple(std::tuple_element_t<Bucketing::template leaves<k>()[i],TreePaths>()...);
+          }, std::make_index_sequence<Bucketing::count(k)>());
+      }
+
+    };
+
+    //! Calls a function for all leaves of a tree, grouped by their type.
+    /**
+     * \code
+     #include <dune/typetree/leaftypes.hh>
+     * \endcode
+     * This function calls `f(leaf, treePath)` for all leaves of the tree, like forEachLeafNode(),
+     * but visits all leaves of one type before the leaves of the next type, as given by
+     * LeafTypeBuckets. Each instantiation of f is thus called back to back for all leaves of its
+     * type, which keeps its instructions and data hot when the leaf types of a tree are
+     * interleaved, e.g. in a composite of a velocity power node and a pressure leaf. The tree
+     * paths are fully static.
+     *
+     * All nodes of the tree must have a static degree.
+     *
+     * \param tree  The tree to traverse.
+     * \param f     The function to call for every leaf.
+     */
+    template<typename Tree, typename F>
+    constexpr void forEachLeafNodeByType (Tree&& tree, F&& f)
+    {
+      using Buckets = LeafTypeBuckets<std::decay_t<Tree>>;
+      Hybrid::forEach(Dune::range(index_constant<Buckets::size()>{}), [&](auto k) {
+        auto paths = Buckets::treePaths(k);
+        Hybrid::forEach(Dune::range(index_constant<Buckets::count(k)>{}), [&](auto i) {
+          f(child(tree,std::get<i>(paths)),std::get<i>(paths));
+        });
+      });
+    }
+
+    //! \} group Tree Traversal
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_LEAFTYPES_HH
@@ -0,0 +1,262 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_LEVELTRAVERSAL_HH
+#define DUNE_TYPETREE_LEVELTRAVERSAL_HH
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/rangeutilities.hh>
+#include <dune/common/typetree/nodeconcepts.hh>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/visitor.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // A node on the frontier of the level-order traversal.
+      template<class Node, class TreePath>
+      struct LevelEntry
+      {
+        Node* node;
+        TreePath treePath;
+      };
+
+      // All nodes of a level that share the same type and tree path type.
+      template<class Node, class TreePath>
+      struct LevelGroup
+      {
+        std::vector<LevelEntry<Node,TreePath>> entries;
+      };
+
+      // The children of Node are collected in a single group with run-time indices
+      // if the degree is dynamic, or if all children have the same type and the visitor
+      // prefers dynamic traversal or the degree exceeds its static degree threshold.
+      template<class Node, class Visitor>
+      constexpr bool hasDynamicChildGroup ()
+      {
+        if constexpr (not Concept::StaticDegreeInnerTreeNode<Node>)
+          return true;
+        else
+          return Detail::dynamicChildIndices<Visitor,Node>();
+      }
+
+      template<class Node, class Index>
+      using LevelChild = std::remove_reference_t<decltype(std::declval<Node&>().child(std::declval<Index>()))>;
+
+      template<class TreePath, class Index>
+      using LevelChildTreePath = decltype(push_back(std::declval<TreePath>(),std::declval<Index>()));
+
+      template<class Visitor, class Node, class TreePath, class Index>
+      constexpr bool visitLevelChild ()
+      {
+        return Visitor::template VisitChild<Node,std::decay_t<LevelChild<Node,Index>>,TreePath>::value;
+      }
+
+      template<class Visitor, class Node, class TreePath, class Index>
+      auto levelChildGroup ()
+      {
+        if constexpr (visitLevelChild<Visitor,Node,TreePath,Index>())
+          return std::tuple<LevelGroup<LevelChild<Node,Index>,LevelChildTreePath<TreePath,Index>>>();
+        else
+          return std::tuple<>();
+      }
+
+      // The groups formed on the next level by the children of the nodes in a group.
+      template<class Visitor, class Node, class TreePath>
+      auto levelChildGroups ()
+      {
+        if constexpr (Concept::LeafTreeNode<Node>)
+          return std::tuple<>();
+        else if constexpr (hasDynamicChildGroup<Node,Visitor>())
+          return levelChildGroup<Visitor,Node,TreePath,std::size_t>();
+        else
+          return unpackIntegerSequence([](auto... i) {
+              return std::tuple_cat(levelChildGroup<Visitor,Node,TreePath,decltype(i)>()...);
+            }, std::make_index_sequence<Node::degree()>());
+      }
+
+      template<class Visitor, class Group>
+      struct LevelChildGroups;
+
+      template<class Visitor, class Node, class TreePath>
+      struct LevelChildGroups<Visitor,LevelGroup<Node,TreePath>>
+      {
+        using type = decltype(levelChildGroups<Visitor,Node,TreePath>());
+      };
+
+      // The position of the first child group of group g within the next level.
+      template<class Visitor, class Level, std::size_t... g>
+      constexpr std::size_t levelChildGroupOffset (std::index_sequence<g...>)
+      {
+        return (std::tuple_size_v<typename LevelChildGroups<Visitor,std::tuple_element_t<g,Level>>::type> + ... + 0);
+      }
+
+      // The number of children of Node before child i that will be visited.
+      template<class Visitor, class Node, class TreePath, std::size_t... j>
+      constexpr std::size_t visitedLevelChildCount (std::index_sequence<j...>)
+      {
+        return (std::size_t(visitLevelChild<Visitor,Node,TreePath,index_constant<j>>()) + ... + 0);
+      }
+
+      template<class Visitor, class Level>
+      struct NextLevel;
+
+      template<class Visitor, class... Group>
+      struct NextLevel<Visitor,std::tuple<Group...>>
+      {
+        using type = decltype(std::tuple_cat(std::declval<typename LevelChildGroups<Visitor,Group>::type>()...));
+      };
+
+      // Computes the tuple of all levels, starting with the given one.
+      template<class Visitor, class Level>
+      auto levels ()
+      {
+        using Next = typename NextLevel<Visitor,Level>::type;
+        if constexpr (std::tuple_size_v<Next> == 0)
+          return std::tuple<Level>();
+        else
+          return std::tuple_cat(std::tuple<Level>(),levels<Visitor,Next>());
+      }
+
+      template<class Tree, class Visitor>
+      using LevelStorage = decltype(levels<Visitor,std::tuple<LevelGroup<Tree,HybridTreePath<>>>>());
+
+      // Appends the visited children of node to their groups on the next level.
+      template<class Visitor, std::size_t offset, class Node, class TreePath, class NextLevel>
+      void pushLevelChildren (Node& node, const TreePath& treePath, NextLevel& next)
+      {
+        if constexpr (hasDynamicChildGroup<Node,Visitor>()) {
+          if constexpr (visitLevelChild<Visitor,Node,TreePath,std::size_t>()) {
+            auto& entries = std::get<offset>(next).entries;
+            for (std::size_t i = 0; i < std::size_t(node.degree()); ++i)
+              entries.push_back({&node.child(i),push_back(treePath,i)});
+          }
+        }
+        else
+          Hybrid::forEach(Dune::range(node.degree()), [&](auto i) {
+            if constexpr (visitLevelChild<Visitor,Node,TreePath,decltype(i)>()) {
+              constexpr std::size_t group = offset + visitedLevelChildCount<Visitor,Node,TreePath>(std::make_index_sequence<i>());
+              std::get<group>(next).entries.push_back({&node.child(i),push_back(treePath,i)});
+            }
+          });
+      }
+
+      template<std::size_t depth, class Levels, class Visitor>
+      void applyToLevel (Levels& levels, Visitor& visitor)
+      {
+        using Level = std::tuple_element_t<depth,Levels>;
+        constexpr bool hasNextLevel = depth + 1 < std::tuple_size_v<Levels>;
+
+        visitor.beginLevel(index_constant<depth>());
+        Hybrid::forEach(Dune::range(index_constant<std::tuple_size_v<Level>>()), [&](auto g) {
+          for (auto& entry : std::get<g>(std::get<depth>(levels)).entries) {
+            auto& node = *entry.node;
+            using Node = std::remove_reference_t<decltype(node)>;
+            if constexpr (Concept::LeafTreeNode<Node>)
+              visitor.leaf(node,entry.treePath);
+            else {
+              visitor.pre(node,entry.treePath);
+              if constexpr (hasNextLevel) {
+                constexpr std::size_t offset = levelChildGroupOffset<Visitor,Level>(std::make_index_sequence<g>());
+                pushLevelChildren<Visitor,offset>(node,entry.treePath,std::get<depth+1>(levels));
+              }
+            }
+          }
+        });
+        visitor.endLevel(index_constant<depth>());
+
+        if constexpr (hasNextLevel)
+          applyToLevel<depth+1>(levels,visitor);
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Reusable buffer for the frontiers of applyToTreeByLevel().
+    /**
+     * The buffer stores the nodes of each level of the tree, grouped by node type and
+     * tree path type. Passing the same buffer to multiple traversals avoids reallocating
+     * the frontiers.
+     *
+     * \tparam Tree     The type of the tree, including a possible const qualifier.
+     * \tparam Visitor  The type of the visitor.
+     */
+    template<class Tree, class Visitor>
+    using LevelTraversalBuffer = Impl::LevelStorage<std::remove_reference_t<Tree>,std::decay_t<Visitor>>;
+
+    //! Apply visitor to the TypeTree in level order.
+    /**
+     * \code
+     #include <dune/typetree/leveltraversal.hh>
+     * \endcode
+     * This function visits all nodes of the tree breadth-first, one level at a time. For each level,
+     * the visitor first receives `beginLevel(depth)`, then `pre()` for every inner node and `leaf()`
+     * for every leaf node of the level, and finally `endLevel(depth)`. The depth is passed as an
+     * index_constant. The callback `endLevel()` thus acts as a barrier between two levels, and the
+     * nodes within a level may be processed concurrently by the visitor. The callbacks `in()`,
+     * `post()`, `beforeChild()` and `afterChild()` are not called.
+     *
+     * The levels of the tree and the types of the nodes on each level are computed at compile time.
+     * Within a level, the nodes are grouped by node type and tree path type, and the nodes of each
+     * group are visited in breadth-first order.
+     * Children are only visited if the `VisitChild` template of the visitor accepts them. As with
+     * applyToTree(), the tree paths contain run-time indices for dynamic power nodes, and also for
+     * static power nodes if the visitor requests dynamic traversal.
+     *
+     * \note The visitor must implement the interface laid out by DefaultLevelVisitor, e.g. by
+     *       inheriting from TreeLevelVisitor, and specify the required type of tree traversal.
+     *
+     * \param tree    The tree the visitor will be applied to.
+     * \param visitor The visitor to apply to the tree.
+     * \param buffer  The buffer for the frontiers of the traversal.
+     */
+    template<Concept::TreeNode Tree, typename Visitor>
+    void applyToTreeByLevel (Tree&& tree, Visitor&& visitor, LevelTraversalBuffer<Tree,Visitor>& buffer)
+    {
+      std::apply([](auto&... level) {
+          (std::apply([](auto&... group) { (group.entries.clear(), ...); }, level), ...);
+        }, buffer);
+      std::get<0>(std::get<0>(buffer)).entries.push_back({&tree,hybridTreePath()});
+      Impl::applyToLevel<0>(buffer,visitor);
+    }
+
+    //! Apply visitor to the TypeTree in level order.
+    /**
+     * This overload allocates a new buffer for the frontiers of the traversal.
+     *
+     * \sa applyToTreeByLevel(Tree&&, Visitor&&, LevelTraversalBuffer<Tree,Visitor>&)
+     */
+    template<Concept::TreeNode Tree, typename Visitor>
+    void applyToTreeByLevel (Tree&& tree, Visitor&& visitor)
+    {
+      LevelTraversalBuffer<Tree,Visitor> buffer;
+      applyToTreeByLevel(tree,visitor,buffer);
+    }
+
+    //! \} group Tree Traversal
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_LEVELTRAVERSAL_HH
@@ -0,0 +1,240 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_MEMORYFOOTPRINT_HH
+#define DUNE_TYPETREE_MEMORYFOOTPRINT_HH
+
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
+#include <dune/common/classname.hh>
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/rangeutilities.hh>
+
+#include <dune/typetree/filteredcompositenode.hh>
+#include <dune/typetree/proxynode.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! The memory used by the nodes of a tree, as computed by memoryFootprint().
+    struct MemoryFootprint
+    {
+
+      //! The memory used by all nodes of a single type.
+      struct NodeType
+      {
+        //! The number of distinct nodes of this type.
+        std::size_t count = 0;
+        //! The size of the node objects plus the heap memory of their child storage.
+        std::size_t bytes = 0;
+      };
+
+      //! The memory per node type, indexed by the demangled type name.
+      std::map<std::string,NodeType> nodeTypes;
+
+      //! The number of distinct nodes, including the nodes wrapped by proxy and filtered nodes.
+      std::size_t nodes = 0;
+
+      //! The total memory of all nodes, i.e. the sum over nodeTypes.
+      std::size_t bytes = 0;
+
+      //! The memory used for storing the children, within the nodes and on the heap.
+      std::size_t storageBytes = 0;
+
+      //! The memory of ProxyNode and FilteredCompositeNode wrappers.
+      std::size_t wrapperBytes = 0;
+
+      //! The number of distinct `shared_ptr` control blocks owning the nodes.
+      std::size_t controlBlocks = 0;
+
+      //! The number of nodes that are referenced by more than one parent.
+      std::size_t sharedNodes = 0;
+
+      //! Writes a summary and the memory per node type.
+      void report (std::ostream& os) const
+      {
+        os << "nodes: " << nodes << ", bytes: " << bytes
+           << ", storage bytes: " << storageBytes
+           << ", wrapper bytes: " << wrapperBytes
+           << ", control blocks: " << controlBlocks
+           << ", shared nodes: " << sharedNodes << "\n";
+        for (const auto& [name, nodeType] : nodeTypes)
+          os << std::setw(12) << nodeType.bytes << std::setw(8) << nodeType.count << "  " << name << "\n";
+      }
+
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // ProxyNode and FilteredCompositeNode only grant derived classes and this friend access to
+      // the wrapped node.
+      struct WrappedNodeAccess
+      {
+        template<typename Node>
+        static std::shared_ptr<const Node> storage (const ProxyNode<Node>& proxy)
+        {
+          return proxy.proxiedNodeStorage();
+        }
+
+        template<typename Node, typename Filter>
+        static std::shared_ptr<const Node> storage (const FilteredCompositeNode<Node,Filter>& filtered)
+        {
+          return filtered.unfilteredStorage();
+        }
+      };
+
+      template<typename Node>
+      std::shared_ptr<const Node> wrappedNodeStorage (const ProxyNode<Node>& proxy)
+      {
+        return WrappedNodeAccess::storage(proxy);
+      }
+
+      template<typename Node, typename Filter>
+      std::shared_ptr<const Node> wrappedNodeStorage (const FilteredCompositeNode<Node,Filter>& filtered)
+      {
+        return WrappedNodeAccess::storage(filtered);
+      }
+
+      template<typename Node>
+      concept FootprintWrapperNode = requires(const Node& node) { Impl::wrappedNodeStorage(node); };
+
+      template<typename Node>
+      const std::string& footprintNodeName ()
+      {
+        static const std::string name = className<Node>();
+        return name;
+      }
+
+      class MemoryFootprintCollector
+      {
+
+      public:
+
+        explicit MemoryFootprintCollector (MemoryFootprint& footprint)
+          : _footprint(footprint)
+        {}
+
+        template<typename Node>
+        void root (const Node& node)
+        {
+          _references[&node] = 1;
+          visit(node);
+        }
+
+      private:
+
+        // Accounts for a reference to a node from its parent or wrapper.
+        template<typename Node>
+        void reference (const std::shared_ptr<const Node>& storage)
+        {
+          if (not storage)
+            return;
+          // non-owning storage, e.g. of nodes with unique ownership, has no control block
+          if (storage.use_count() > 0 and _owners.insert(storage).second)
+            ++_footprint.controlBlocks;
+          std::size_t& references = ++_references[storage.get()];
+          if (references == 2)
+            ++_footprint.sharedNodes;
+          if (references == 1)
+            visit(*storage);
+        }
+
+        // Accounts for a node that is encountered for the first time.
+        template<typename Node>
+        void visit (const Node& node)
+        {
+          std::size_t bytes = sizeof(Node);
+          if constexpr (FootprintWrapperNode<Node>) {
+            _footprint.wrapperBytes += sizeof(Node);
+            reference(wrappedNodeStorage(node));
+          }
+          else if constexpr (not Node::isLeaf) {
+            const auto& storage = node.nodeStorage();
+            _footprint.storageBytes += sizeof(storage);
+            if constexpr (requires { storage.capacity(); }) {
+              const std::size_t heapBytes = storage.capacity() * sizeof(typename std::decay_t<decltype(storage)>::value_type);
+              _footprint.storageBytes += heapBytes;
+              bytes += heapBytes;
+            }
+            Hybrid::forEach(Dune::range(node.degree()), [&](auto i) {
+              using Child = std::decay_t<decltype(node.child(i))>;
+              if constexpr (requires { node.childStorage(i); })
+                reference(std::shared_ptr<const Child>(node.childStorage(i)));
+              // uniquely owned children have no control block and may have been released
+              else if constexpr (requires { storage[i].get(); })
+                reference(std::shared_ptr<const Child>(std::shared_ptr<const Child>(),storage[i].get()));
+              else if constexpr (requires { std::get<i>(storage).get(); })
+                reference(std::shared_ptr<const Child>(std::shared_ptr<const Child>(),std::get<i>(storage).get()));
+              else
+                // children stored by value have no control block either
+                reference(std::shared_ptr<const Child>(std::shared_ptr<const Child>(),&node.child(i)));
+            });
+          }
+          auto& nodeType = _footprint.nodeTypes[footprintNodeName<Node>()];
+          ++nodeType.count;
+          nodeType.bytes += bytes;
+          ++_footprint.nodes;
+          _footprint.bytes += bytes;
+        }
+
+        MemoryFootprint& _footprint;
+        std::set<std::shared_ptr<const void>,std::owner_less<>> _owners;
+        std::unordered_map<const void*,std::size_t> _references;
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Computes the memory used by the nodes of a tree.
+    /**
+     * \code
+     #include <dune/typetree/memoryfootprint.hh>
+     * \endcode
+     * The function visits every distinct node of the tree once and reports the size of the node
+     * objects per node type, including the child storage of PowerNode (`std::array`), CompositeNode
+     * (`std::tuple`) and the heap memory of the `std::vector` in DynamicPowerNode. ProxyNode and
+     * FilteredCompositeNode are counted as wrappers, and the wrapped node is visited in their place,
+     * including children that are removed by the filter. Nodes that are reachable from several
+     * parents are counted once and reported in MemoryFootprint::sharedNodes.
+     *
+     * The number of `shared_ptr` control blocks is reported separately, as their size depends on the
+     * standard library and the way the nodes were allocated. The root node is passed by reference
+     * and does not contribute a control block. Memory allocated by the nodes for their payload is
+     * not included.
+     *
+     * \param tree  The tree to measure.
+     * \returns     The memory footprint of the tree.
+     */
+    template<typename Tree>
+    MemoryFootprint memoryFootprint (const Tree& tree)
+    {
+      MemoryFootprint footprint;
+      Impl::MemoryFootprintCollector(footprint).root(tree);
+      return footprint;
+    }
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_MEMORYFOOTPRINT_HH
@@ -0,0 +1,114 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_MEMORYRESOURCE_HH
+#define DUNE_TYPETREE_MEMORYRESOURCE_HH
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include <dune/common/std/type_traits.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! Allocates a node of type T from the given memory resource.
+    /**
+     * The node and the control block of the returned shared_ptr are allocated together from
+     * memoryResource by means of a `std::pmr::polymorphic_allocator`. The memory resource must
+     * outlive the returned node and all copies of its storage.
+     *
+     * This function can be used as a node factory to construct the children of a tree with a
+     * custom memory resource, e.g. a `std::pmr::monotonic_buffer_resource` that is thrown away
+     * together with the tree.
+     */
+    template<typename T, typename... Args>
+    std::shared_ptr<T> allocateNode (std::pmr::memory_resource* memoryResource, Args&&... args)
+    {
+      return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(memoryResource),std::forward<Args>(args)...);
+    }
+
+    /** \} */
+
+    /** \addtogroup Transformation
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! Mixin base class for transformations that allocate the transformed nodes from a memory resource.
+    /**
+     * The transformation descriptors shipped with TypeTree allocate the storage of transformed nodes
+     * via makeNodeStorage(). If the transformation provides a method memoryResource(), all nodes
+     * are allocated from that resource instead of the global heap. Deriving a transformation from
+     * this class is the simplest way to provide this method:
+     *
+     * \code
+     * struct MyTransformation : public Dune::TypeTree::MemoryResourceTransformation
+     * {
+     *   using MemoryResourceTransformation::MemoryResourceTransformation;
+     * };
+     *
+     * std::pmr::monotonic_buffer_resource buffer;
+     * auto transformed = TransformTree<Tree,MyTransformation>::transform_storage(tree,MyTransformation(&buffer));
+     * \endcode
+     *
+     * \warning The memory resource must outlive the transformed tree.
+     */
+    class MemoryResourceTransformation
+    {
+
+    public:
+
+      explicit MemoryResourceTransformation (std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+        : _memoryResource(memoryResource)
+      {}
+
+      //! Returns the memory resource used for allocating transformed nodes.
+      std::pmr::memory_resource* memoryResource () const
+      {
+        return _memoryResource;
+      }
+
+    private:
+      std::pmr::memory_resource* _memoryResource;
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename Transformation>
+      using HasMemoryResource = decltype(std::declval<const Transformation&>().memoryResource());
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Creates the storage of a transformed node of type T.
+    /**
+     * If transformation provides a method memoryResource(), the node is allocated from that
+     * resource with allocateNode(). Otherwise, it is allocated with std::make_shared().
+     */
+    template<typename T, typename Transformation, typename... Args>
+    std::shared_ptr<T> makeNodeStorage (const Transformation& transformation, Args&&... args)
+    {
+      if constexpr (Std::is_detected_v<Impl::HasMemoryResource,Transformation>)
+        return allocateNode<T>(transformation.memoryResource(),std::forward<Args>(args)...);
+      else
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    //! \} group Transformation
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_MEMORYRESOURCE_HH
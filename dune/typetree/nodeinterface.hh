@@ -106,6 +106,39 @@ namespace Dune {
     template<typename Node>
     using StaticDegree = decltype(Node::degree());
 
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename Node>
+      struct MaxDegree
+      {};
+
+      template<typename Node>
+        requires requires { Node::maxDegree(); }
+      struct MaxDegree<Node>
+        : std::integral_constant<std::size_t,Node::maxDegree()>
+      {};
+
+      template<typename Node>
+        requires (not requires { Node::maxDegree(); }) and requires { StaticDegree<Node>::value; }
+      struct MaxDegree<Node>
+        : std::integral_constant<std::size_t,StaticDegree<Node>::value>
+      {};
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Returns a compile-time upper bound of the degree of the given Node type as a std::integral_constant.
+    /**
+     * For nodes with a static degree, this is the same as StaticDegree. Nodes with a bounded
+     * run-time degree, like BoundedDynamicPowerNode, provide the bound by a static member
+     * function maxDegree(). The alias is not defined for nodes with an unbounded degree.
+     */
+    template<typename Node>
+    using MaxDegree = std::integral_constant<std::size_t,Impl::MaxDegree<std::decay_t<Node>>::value>;
+
     //! \} group Nodes
 
   } // namespace TypeTree
@@ -0,0 +1,311 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_PACKEDTREEPATH_HH
+#define DUNE_TYPETREE_PACKEDTREEPATH_HH
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/rangeutilities.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/typetraits.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    //! \addtogroup TreePath
+    //! \ingroup TypeTree
+    //! \{
+
+    //! A tree path packed into a fixed number of 64-bit words.
+    /**
+     * A PackedTreePath stores the entries of a tree path as bit fields of the given words,
+     * starting with the most significant bit of the first word. The width of the bit field
+     * of each level is defined by a PackedTreePathLayout, which is required to create paths,
+     * to append entries and to convert them back into a HybridTreePath.
+     *
+     * Comparison, hashing and the prefix test do not require the layout and only operate
+     * on the packed words, so PackedTreePath can directly be used as key in hash maps and
+     * ordered containers. Paths created by the same layout are ordered lexicographically,
+     * i.e., in the order of a depth-first pre-order traversal.
+     *
+     * \tparam words  The number of 64-bit words used for storing the path.
+     */
+    template<std::size_t words = 2>
+    class PackedTreePath
+    {
+
+      static_assert(words > 0, "PackedTreePath requires at least one word");
+
+      friend class PackedTreePathLayout;
+
+    public:
+
+      //! The maximum number of bits available for storing entries.
+      static constexpr std::size_t capacity = 64*words;
+
+      //! Constructs the empty tree path pointing to the root node.
+      constexpr PackedTreePath ()
+        : _data{}
+        , _size(0)
+        , _bits(0)
+      {}
+
+      //! Returns the number of entries.
+      constexpr std::size_t size () const
+      {
+        return _size;
+      }
+
+      //! Returns the number of bits occupied by the entries, including padding between words.
+      constexpr std::size_t bits () const
+      {
+        return _bits;
+      }
+
+      //! Returns the packed words.
+      constexpr const std::array<std::uint64_t,words>& data () const
+      {
+        return _data;
+      }
+
+      //! Returns a hash value of the path.
+      std::size_t hash () const
+      {
+        std::uint64_t h = _size;
+        for (std::size_t w = 0; w < words; ++w)
+          h = mix(h ^ (_data[w] + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2)));
+        return std::size_t(h);
+      }
+
+      friend constexpr bool operator== (const PackedTreePath& a, const PackedTreePath& b)
+      {
+        return a._size == b._size && a._data == b._data;
+      }
+
+      friend constexpr bool operator!= (const PackedTreePath& a, const PackedTreePath& b)
+      {
+        return not (a == b);
+      }
+
+      //! Lexicographic ordering of paths created by the same layout.
+      friend constexpr bool operator< (const PackedTreePath& a, const PackedTreePath& b)
+      {
+        if (a._data != b._data)
+          return a._data < b._data;
+        return a._size < b._size;
+      }
+
+      //! Returns true if prefix is a prefix of path.
+      /**
+       * Both paths must have been created by the same layout. Every path is a prefix of itself.
+       */
+      friend constexpr bool isPrefix (const PackedTreePath& prefix, const PackedTreePath& path)
+      {
+        if (prefix._size > path._size)
+          return false;
+        std::size_t bits = prefix._bits;
+        for (std::size_t w = 0; w < words && bits > 0; ++w) {
+          std::uint64_t mask = bits >= 64 ? ~std::uint64_t(0) : ~(~std::uint64_t(0) >> bits);
+          if ((prefix._data[w] ^ path._data[w]) & mask)
+            return false;
+          bits -= std::min<std::size_t>(bits,64);
+        }
+        return true;
+      }
+
+    private:
+
+      static constexpr std::uint64_t mix (std::uint64_t x)
+      {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+      }
+
+      std::array<std::uint64_t,words> _data;
+      std::uint8_t _size;
+      std::uint16_t _bits;
+    };
+
+
+    //! Bit layout of the PackedTreePaths of a tree.
+    /**
+     * The layout assigns a fixed number of bits to each level of the tree, which is
+     * derived from the maximum degree of all nodes on that level. Bit fields never span
+     * two words, so a level may start with some padding bits. If a path or index does
+     * not fit into the layout or into the words of the PackedTreePath, a RangeError is
+     * thrown. This can happen if the degree of a dynamic node grows after the layout
+     * has been created.
+     */
+    class PackedTreePathLayout
+    {
+
+    public:
+
+      //! Constructs a layout from the maximum degree of the nodes on each level.
+      explicit PackedTreePathLayout (const std::vector<std::size_t>& maxDegrees)
+      {
+        std::size_t offset = 0;
+        for (std::size_t degree : maxDegrees) {
+          std::size_t width = std::max<std::size_t>(std::bit_width(std::max<std::size_t>(degree,1) - 1),1);
+          if (offset / 64 != (offset + width - 1) / 64)
+            offset = (offset / 64 + 1) * 64;
+          _width.push_back(width);
+          _offset.push_back(offset);
+          offset += width;
+        }
+        if (depth() > 255)
+          DUNE_THROW(RangeError, "PackedTreePathLayout supports at most 255 levels");
+      }
+
+      //! Constructs the layout for the given tree.
+      template<typename Tree,
+        std::enable_if_t<has_node_tag<Tree>::value, int> = 0>
+      explicit PackedTreePathLayout (const Tree& tree)
+        : PackedTreePathLayout(maxDegrees(tree))
+      {}
+
+      //! Returns the maximum number of entries of a path.
+      std::size_t depth () const
+      {
+        return _width.size();
+      }
+
+      //! Returns the number of bits of the entries on the given level.
+      std::size_t width (std::size_t level) const
+      {
+        return _width[level];
+      }
+
+      //! Returns the number of bits required for a path with the given number of entries.
+      std::size_t bits (std::size_t size) const
+      {
+        assert(size <= depth());
+        return size > 0 ? _offset[size-1] + _width[size-1] : 0;
+      }
+
+      //! Returns the path obtained by appending the entry i to path.
+      template<std::size_t words>
+      PackedTreePath<words> push_back (PackedTreePath<words> path, std::size_t i) const
+      {
+        std::size_t level = path._size;
+        if (level >= depth())
+          DUNE_THROW(RangeError, "Tree path exceeds the depth " << depth() << " of the PackedTreePathLayout");
+        if (i >> _width[level])
+          DUNE_THROW(RangeError, "Index " << i << " does not fit into the " << _width[level] << " bits of level " << level);
+        std::size_t offset = _offset[level];
+        if (offset + _width[level] > PackedTreePath<words>::capacity)
+          DUNE_THROW(RangeError, "Tree path does not fit into " << words << " words");
+        path._data[offset / 64] |= std::uint64_t(i) << (64 - offset % 64 - _width[level]);
+        path._size = level + 1;
+        path._bits = offset + _width[level];
+        return path;
+      }
+
+      //! Returns the entry of path on the given level.
+      template<std::size_t words>
+      std::size_t entry (const PackedTreePath<words>& path, std::size_t level) const
+      {
+        assert(level < path.size());
+        std::size_t offset = _offset[level];
+        std::uint64_t mask = (std::uint64_t(1) << _width[level]) - 1;
+        return (path._data[offset / 64] >> (64 - offset % 64 - _width[level])) & mask;
+      }
+
+      //! Packs a HybridTreePath.
+      template<std::size_t words = 2, typename... T>
+      PackedTreePath<words> pack (const HybridTreePath<T...>& tp) const
+      {
+        PackedTreePath<words> path;
+        for (std::size_t i = 0; i < tp.size(); ++i)
+          path = push_back(path,tp[i]);
+        return path;
+      }
+
+      //! Unpacks path into a HybridTreePath of the given type.
+      /**
+       * Static entries of TreePath are not read from path, but are checked against it
+       * in debug mode.
+       */
+      template<typename TreePath, std::size_t words>
+      TreePath unpack (const PackedTreePath<words>& path) const
+      {
+        assert(path.size() == TreePath::size());
+        return unpackIntegerSequence([&](auto... i) {
+          return TreePath(unpackEntry<std::decay_t<decltype(std::declval<TreePath>()[i])>>(path,i)...);
+        }, std::make_index_sequence<TreePath::size()>{});
+      }
+
+    private:
+
+      template<typename Entry, std::size_t words>
+      Entry unpackEntry (const PackedTreePath<words>& path, std::size_t level) const
+      {
+        if constexpr (IsIntegralConstant<Entry>::value) {
+          assert(entry(path,level) == Entry::value);
+          return Entry{};
+        }
+        else
+          return entry(path,level);
+      }
+
+      template<typename Node>
+      static void collectMaxDegrees (const Node& node, std::size_t level, std::vector<std::size_t>& maxDegrees)
+      {
+        if constexpr (not Node::isLeaf) {
+          if (maxDegrees.size() <= level)
+            maxDegrees.resize(level + 1, 0);
+          maxDegrees[level] = std::max<std::size_t>(maxDegrees[level],node.degree());
+          Hybrid::forEach(Dune::range(node.degree()), [&](auto i) {
+            collectMaxDegrees(node.child(i),level + 1,maxDegrees);
+          });
+        }
+      }
+
+      template<typename Tree>
+      static std::vector<std::size_t> maxDegrees (const Tree& tree)
+      {
+        std::vector<std::size_t> result;
+        collectMaxDegrees(tree,0,result);
+        return result;
+      }
+
+      std::vector<std::size_t> _width;
+      std::vector<std::size_t> _offset;
+    };
+
+    //! \} group TreePath
+
+  } // namespace TypeTree
+} //namespace Dune
+
+template<std::size_t words>
+struct std::hash<Dune::TypeTree::PackedTreePath<words>>
+{
+  std::size_t operator() (const Dune::TypeTree::PackedTreePath<words>& path) const
+  {
+    return path.hash();
+  }
+};
+
+#endif // DUNE_TYPETREE_PACKEDTREEPATH_HH
@@ -6,6 +6,8 @@
 #ifndef DUNE_TYPETREE_PAIRTRAVERSAL_HH
 #define DUNE_TYPETREE_PAIRTRAVERSAL_HH
 
+#include <type_traits>
+
 #include <dune/common/std/type_traits.hh>
 
 #include <dune/typetree/nodeinterface.hh>
@@ -24,6 +26,29 @@ namespace Dune {
 
     namespace Detail {
 
+      template<class Visitor>
+      using PruneIdenticalConcept = decltype(Visitor::pruneIdentical);
+
+      // Checks whether the visitor skips pairs of identical nodes.
+      template<class Visitor>
+      constexpr bool pruneIdentical()
+      {
+        if constexpr (Dune::Std::is_detected_v<PruneIdenticalConcept,Visitor>)
+          return Visitor::pruneIdentical;
+        else
+          return false;
+      }
+
+      // Checks whether both nodes are the same object, if the visitor prunes identical subtrees.
+      template<class Visitor, class T1, class T2>
+      bool isPrunedPair(const T1& tree1, const T2& tree2)
+      {
+        if constexpr (pruneIdentical<Visitor>() and std::is_same_v<T1,T2>)
+          return &tree1 == &tree2;
+        else
+          return false;
+      }
+
       /* The signature is the same as for the public applyToTreePair
        * function in Dune::Typtree, despite the additionally passed
        * treePath argument. The path passed here is associated to
@@ -70,8 +95,10 @@ namespace Dune {
         // both trees must support either dynamic or static traversal
         static_assert(allowDynamicTraversal::value || allowStaticTraversal::value);
 
-        // the visitor may specify preferred dynamic traversal
-        using preferDynamicTraversal = std::bool_constant<Visitor::treePathType == TreePathType::dynamic>;
+        // the visitor may specify preferred dynamic traversal or a static degree threshold, which is
+        // checked for both trees, as e.g. a static power node may be paired with a dynamic one
+        using preferDynamicTraversal = std::bool_constant<Visitor::treePathType == TreePathType::dynamic
+          or dynamicChildIndices<Visitor,Tree1>() or dynamicChildIndices<Visitor,Tree2>()>;
 
         // create a dynamic or static index range
         auto indices = [&]{
@@ -98,7 +125,10 @@ namespace Dune {
             constexpr bool visitChild = Visitor::template VisitChild<Tree1,Child1,Tree2,Child2,TreePath>::value;
             if constexpr(visitChild) {
               auto childTreePath = Dune::TypeTree::push_back(treePath, i);
-              applyToTreePair(child1, child2, childTreePath, visitor);
+              if (isPrunedPair<Visitor>(child1, child2))
+                visitor.identical(child1, child2, childTreePath);
+              else
+                applyToTreePair(child1, child2, childTreePath, visitor);
             }
 
             visitor.afterChild(tree1, child1, tree2, child2, treePath, i);
@@ -120,6 +150,9 @@ namespace Dune {
      *       inheriting from it) and specify the required type of tree traversal (static or dynamic) by
      *       inheriting from either StaticTraversal or DynamicTraversal.
      *
+     * If the visitor inherits from PruneIdenticalSubtrees, pairs of nodes that are the same object are
+     * not traversed. Instead, the visitor's `identical()` method is called for them.
+     *
      * \param tree1   The first tree the visitor will be applied to.
      * \param tree2   The second tree the visitor will be applied to.
      * \param visitor The visitor to apply to the trees.
@@ -127,7 +160,11 @@ namespace Dune {
     template<typename Tree1, typename Tree2, typename Visitor>
     void applyToTreePair(Tree1&& tree1, Tree2&& tree2, Visitor&& visitor)
     {
-      Detail::applyToTreePair(tree1, tree2, hybridTreePath(), visitor);
+      using V = std::remove_reference_t<Visitor>;
+      if (Detail::isPrunedPair<V>(tree1, tree2))
+        visitor.identical(tree1, tree2, hybridTreePath());
+      else
+        Detail::applyToTreePair(tree1, tree2, hybridTreePath(), visitor);
     }
 
     //! \} group Tree Traversal
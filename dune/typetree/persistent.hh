@@ -0,0 +1,110 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_PERSISTENT_HH
+#define DUNE_TYPETREE_PERSISTENT_HH
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/indices.hh>
+
+#include <dune/typetree/treepath.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // Stores child as the i-th child of node, using the static setChild() overload if the node has one.
+      template<typename Node, typename Index, typename Child>
+      void setPersistentChild (Node& node, Index i, std::shared_ptr<Child> child)
+      {
+        if constexpr (requires { node.setChild(std::move(child),i); })
+          node.setChild(std::move(child),i);
+        else
+          node.setChild(std::size_t(i),std::move(child));
+      }
+
+      // Copies node and replaces the child given by the indices in the copy, copying all
+      // nodes along the way. The copies share all other children with the original nodes.
+      template<typename Node, typename Child, typename I0, typename... I>
+      std::shared_ptr<Node> withChild (const Node& node, std::shared_ptr<Child>& child, I0 i0, I... i)
+      {
+        using NodeChild = std::decay_t<decltype(node.child(i0))>;
+        std::shared_ptr<NodeChild> replacement;
+        if constexpr (sizeof...(I) == 0) {
+          static_assert(std::is_same_v<NodeChild,Child>, "The new child must have the same type as the replaced child");
+          replacement = std::move(child);
+        }
+        else
+          replacement = Impl::withChild(node.child(i0),child,i...);
+        auto copy = std::make_shared<Node>(node);
+        setPersistentChild(*copy,i0,std::move(replacement));
+        return copy;
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Returns a copy of a tree with the child at the given tree path replaced.
+    /**
+     * \code
+     #include <dune/typetree/persistent.hh>
+     * \endcode
+     * The function treats the tree as a persistent data structure: It does not modify the tree,
+     * but copies all nodes on the path from the root to the replaced child and returns the copy
+     * of the root. The copied nodes share all unchanged subtrees with the original tree, so an
+     * update costs O(depth) node copies instead of a deep copy of the tree. Readers that hold the
+     * original tree keep a consistent snapshot without any locking, as long as no one modifies
+     * the nodes of either tree in place, e.g. by calling setChild().
+     *
+     * The nodes on the path are copied with their copy constructors, which must copy the child
+     * storage instead of the children. This is the case for PowerNode, DynamicPowerNode and
+     * CompositeNode. The nodes must also provide a setChild() method that accepts the child
+     * storage.
+     *
+     * \param tree      The tree to update.
+     * \param treePath  The non-empty path of the child to replace.
+     * \param child     The new child, which must have the same type as the replaced child.
+     * \returns         The root of the updated tree.
+     */
+    template<typename Tree, typename... I, typename Child>
+    std::shared_ptr<const Tree> withChild (const Tree& tree, const HybridTreePath<I...>& treePath, std::shared_ptr<Child> child)
+    {
+      static_assert(sizeof...(I) > 0, "withChild() requires a non-empty tree path");
+      return unpackIntegerSequence([&](auto... k) {
+          return Impl::withChild(tree,child,treePath[k]...);
+        }, std::index_sequence_for<I...>());
+    }
+
+    //! Returns a copy of a tree with the child at the given tree path replaced.
+    /**
+     * This overload moves or copies the new child into a newly allocated node.
+     *
+     * \sa withChild(const Tree&, const HybridTreePath<I...>&, std::shared_ptr<Child>)
+     */
+    template<typename Tree, typename... I, typename Child>
+    std::shared_ptr<const Tree> withChild (const Tree& tree, const HybridTreePath<I...>& treePath, Child&& child)
+    {
+      return withChild(tree,treePath,std::make_shared<std::decay_t<Child>>(std::forward<Child>(child)));
+    }
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_PERSISTENT_HH
@@ -138,6 +138,21 @@ namespace Dune {
         return _children[i];
       }
 
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      template<std::size_t i>
+      const std::shared_ptr<T>& childStorageRef (index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        return _children[i];
+      }
+
       //! Sets the i-th child to the passed-in value.
       template<std::size_t i>
       void setChild (T& t, index_constant<i> = {})
@@ -208,6 +223,20 @@ namespace Dune {
         return _children[i];
       }
 
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      const std::shared_ptr<T>& childStorageRef (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
       //! Sets the i-th child to the passed-in value.
       void setChild (std::size_t i, T& t)
       {
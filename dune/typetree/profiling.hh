@@ -0,0 +1,541 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_PROFILING_HH
+#define DUNE_TYPETREE_PROFILING_HH
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/classname.hh>
+#include <dune/common/indices.hh>
+
+#include <dune/typetree/profilinghooks.hh>
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/visitor.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! Collects timings of visitor callbacks and node transformations.
+    /**
+     * The profiler aggregates the number of calls and the accumulated wall time for each
+     * combination of callback, node type and tree path. Optionally, it also keeps every single
+     * call as an event, which can be written in the Chrome trace event format and then viewed
+     * as a flame graph, e.g. in `chrome://tracing` or Perfetto.
+     *
+     * Measurements are keyed by the callback id, a node type id and the entries of the tree path,
+     * so recording does not format any names. The names are only computed for the report and the
+     * trace.
+     *
+     * \sa ProfilingVisitor, ProfilingTransformation
+     */
+    class Profiler
+    {
+
+    public:
+
+      using Clock = std::chrono::steady_clock;
+
+      //! Identifies the callback of a measurement.
+      using Callback = ProfilingCallback;
+
+      //! Identifies a node type by a function that returns the name of the type.
+      using NodeTypeId = const std::string& (*)();
+
+      //! Returns the name of a callback.
+      static const char* callbackName (Callback callback)
+      {
+        static const char* names[] = {
+          "pre", "in", "post", "leaf", "beforeChild", "afterChild", "identical", "subtree",
+          "transform", "transform_storage"
+        };
+        return names[static_cast<std::size_t>(callback)];
+      }
+
+      //! Formats the entries of a tree path like a HybridTreePath.
+      static std::string treePathName (std::span<const std::size_t> treePath)
+      {
+        std::ostringstream s;
+        s << "[";
+        for (std::size_t entry : treePath)
+          s << " " << entry;
+        s << " ]";
+        return s.str();
+      }
+
+      //! Identifies a measurement by callback, node type and tree path.
+      struct Key
+      {
+        Callback callback;
+        NodeTypeId nodeTypeId;
+        std::vector<std::size_t> treePathEntries;
+
+        //! Returns the name of the callback.
+        const char* callbackName () const
+        {
+          return Profiler::callbackName(callback);
+        }
+
+        //! Returns the name of the node type.
+        const std::string& nodeType () const
+        {
+          return nodeTypeId();
+        }
+
+        //! Returns the formatted tree path.
+        std::string treePath () const
+        {
+          return Profiler::treePathName(treePathEntries);
+        }
+      };
+
+    private:
+
+      // A key that refers to the tree path entries instead of owning them, used for the lookup.
+      struct KeyView
+      {
+        Callback callback;
+        NodeTypeId nodeTypeId;
+        std::span<const std::size_t> treePathEntries;
+      };
+
+      struct KeyHash
+      {
+        using is_transparent = void;
+
+        template<typename K>
+        std::size_t operator() (const K& key) const
+        {
+          std::size_t hash = std::hash<NodeTypeId>()(key.nodeTypeId) ^ static_cast<std::size_t>(key.callback);
+          for (std::size_t entry : key.treePathEntries)
+            hash = hash * 31 + entry;
+          return hash;
+        }
+      };
+
+      struct KeyEqual
+      {
+        using is_transparent = void;
+
+        template<typename K1, typename K2>
+        bool operator() (const K1& a, const K2& b) const
+        {
+          return a.callback == b.callback and a.nodeTypeId == b.nodeTypeId
+            and std::ranges::equal(a.treePathEntries,b.treePathEntries);
+        }
+      };
+
+    public:
+
+      //! Aggregated measurements for a single key.
+      struct Statistics
+      {
+        std::size_t count = 0;
+        Clock::duration time = Clock::duration::zero();
+      };
+
+      //! The aggregated measurements of all keys.
+      using StatisticsMap = std::unordered_map<Key,Statistics,KeyHash,KeyEqual>;
+
+      //! Creates a profiler, which records single events if recordTrace is true.
+      explicit Profiler (bool recordTrace = false)
+        : _recordTrace(recordTrace)
+        , _origin(Clock::now())
+      {}
+
+      //! Records a call of callback for a node of the type nodeType at position treePath.
+      /**
+       * The tree path is only copied for the first measurement of a key.
+       */
+      void record (Callback callback, NodeTypeId nodeType, std::span<const std::size_t> treePath,
+                   Clock::time_point start, Clock::time_point end)
+      {
+        auto it = _statistics.find(KeyView{callback,nodeType,treePath});
+        if (it == _statistics.end())
+          it = _statistics.emplace(Key{callback,nodeType,{treePath.begin(),treePath.end()}},Statistics{}).first;
+        ++it->second.count;
+        it->second.time += end - start;
+        if (_recordTrace) {
+          _events.push_back({callback,nodeType,_eventTreePaths.size(),treePath.size(),start,end});
+          _eventTreePaths.insert(_eventTreePaths.end(),treePath.begin(),treePath.end());
+        }
+      }
+
+      //! Returns the aggregated measurements.
+      const StatisticsMap& statistics () const
+      {
+        return _statistics;
+      }
+
+      //! Discards all measurements.
+      void clear ()
+      {
+        _statistics.clear();
+        _events.clear();
+        _eventTreePaths.clear();
+        _origin = Clock::now();
+      }
+
+      //! Writes a table of the aggregated measurements, sorted by decreasing accumulated time.
+      void report (std::ostream& os) const
+      {
+        std::vector<const StatisticsMap::value_type*> entries;
+        entries.reserve(_statistics.size());
+        for (const auto& entry : _statistics)
+          entries.push_back(&entry);
+        std::stable_sort(entries.begin(),entries.end(),[](const auto* a, const auto* b) {
+          return a->second.time > b->second.time;
+        });
+        os << std::setw(14) << "time [us]" << std::setw(10) << "calls"
+           << "  callback  node type  tree path\n";
+        for (const auto* entry : entries) {
+          const auto& [key, statistics] = *entry;
+          os << std::setw(14) << std::fixed << std::setprecision(3) << microseconds(statistics.time)
+             << std::setw(10) << statistics.count
+             << "  " << key.callbackName() << "  " << key.nodeType() << "  " << key.treePath() << "\n";
+        }
+      }
+
+      //! Writes the recorded events in the Chrome trace event format (JSON).
+      /**
+       * This requires the profiler to be constructed with recordTrace set to true.
+       */
+      void writeChromeTrace (std::ostream& os) const
+      {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& event : _events) {
+          os << (first ? "\n" : ",\n");
+          first = false;
+          std::span<const std::size_t> treePath(_eventTreePaths.data() + event.treePathOffset,event.treePathSize);
+          os << "{\"name\":\"" << escape(event.nodeTypeId()) << "\""
+             << ",\"cat\":\"" << callbackName(event.callback) << "\""
+             << ",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+             << ",\"ts\":" << std::fixed << std::setprecision(3) << microseconds(event.start - _origin)
+             << ",\"dur\":" << microseconds(event.end - event.start)
+             << ",\"args\":{\"treePath\":\"" << treePathName(treePath) << "\"}}";
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+      }
+
+    private:
+
+      // a single call, whose tree path is stored in _eventTreePaths
+      struct Event
+      {
+        Callback callback;
+        NodeTypeId nodeTypeId;
+        std::size_t treePathOffset;
+        std::size_t treePathSize;
+        Clock::time_point start;
+        Clock::time_point end;
+      };
+
+      static double microseconds (Clock::duration d)
+      {
+        return std::chrono::duration<double,std::micro>(d).count();
+      }
+
+      static std::string escape (const std::string& s)
+      {
+        std::string result;
+        for (char c : s) {
+          if (c == '"' or c == '\\')
+            result += '\\';
+          result += c;
+        }
+        return result;
+      }
+
+      bool _recordTrace;
+      Clock::time_point _origin;
+      StatisticsMap _statistics;
+      std::vector<Event> _events;
+      std::vector<std::size_t> _eventTreePaths;
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // The demangled name of a node type, computed once per type and only on demand. The address
+      // of the function identifies the node type in a Profiler.
+      template<typename T>
+      const std::string& profilingNodeName ()
+      {
+        static const std::string name = className<std::decay_t<T>>();
+        return name;
+      }
+
+      template<typename T>
+      struct IsProfilingTreePath : std::false_type {};
+
+      template<typename... T>
+      struct IsProfilingTreePath<HybridTreePath<T...>> : std::true_type {};
+
+      // The position of the first tree path among the callback arguments.
+      template<typename... Args>
+      constexpr std::size_t profilingTreePathPosition ()
+      {
+        std::size_t i = 0;
+        (void)((IsProfilingTreePath<std::decay_t<Args>>::value or (++i, false)) or ...);
+        return i;
+      }
+
+      // The entries of the first tree path among the callback arguments, without formatting it.
+      template<typename... Args>
+      auto profilingTreePath (const Args&... args)
+      {
+        constexpr std::size_t i = profilingTreePathPosition<Args...>();
+        if constexpr (i == sizeof...(Args))
+          return std::array<std::size_t,0>{};
+        else {
+          const auto& treePath = std::get<i>(std::forward_as_tuple(args...));
+          return unpackIntegerSequence([&](auto... k) {
+              return std::array<std::size_t,sizeof...(k)>{std::size_t(treePath[k])...};
+            }, std::make_index_sequence<std::decay_t<decltype(treePath)>::size()>());
+        }
+      }
+
+      // The node type id of T in a Profiler.
+      template<typename T>
+      constexpr Profiler::NodeTypeId profilingNodeType ()
+      {
+        return &profilingNodeName<std::decay_t<T>>;
+      }
+
+      template<typename Visitor>
+      constexpr bool profilingPruneIdentical ()
+      {
+        if constexpr (requires { Visitor::pruneIdentical; })
+          return Visitor::pruneIdentical;
+        else
+          return false;
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! Visitor adapter that measures the callbacks of another visitor.
+    /**
+     * ProfilingVisitor forwards all callbacks to the wrapped visitor and records their wall time
+     * in a Profiler, keyed by the callback, the type of the (first) node and the tree path. In addition, the time between `pre()` and `post()` of a node is recorded as callback
+     * `subtree`, which includes the time spent in the children.
+     *
+     * The adapter works with applyToTree(), applyToTreePair() and Experimental::hybridApplyToTree(),
+     * as it forwards arbitrary callback arguments and return values. It adopts the traversal type,
+     * the static degree threshold, the `VisitChild` template and the pruning of identical subtrees
+     * from the wrapped visitor.
+     *
+     * \tparam V  The type of the wrapped visitor. Lvalue reference types are stored as references,
+     *            all other types by value.
+     */
+    template<typename V>
+    class ProfilingVisitor
+    {
+
+      using Visitor = std::decay_t<V>;
+      using Clock = Profiler::Clock;
+
+    public:
+
+      //! Use the traversal type of the wrapped visitor.
+      static const TreePathType::Type treePathType = Visitor::treePathType;
+
+      //! Skip identical subtrees in pair traversals if the wrapped visitor does.
+      static const bool pruneIdentical = Impl::profilingPruneIdentical<Visitor>();
+
+      //! Use the static degree threshold of the wrapped visitor.
+      static const std::size_t staticDegreeThreshold = Impl::staticDegreeThreshold<Visitor>();
+
+      //! Visit the children visited by the wrapped visitor.
+      template<typename... T>
+      struct VisitChild
+        : public Visitor::template VisitChild<T...>
+      {};
+
+      ProfilingVisitor (V&& visitor, Profiler& profiler)
+        : _visitor(std::forward<V>(visitor))
+        , _profiler(&profiler)
+      {}
+
+      //! Returns the wrapped visitor.
+      auto& visitor ()
+      {
+        return _visitor;
+      }
+
+      //! Returns the wrapped visitor (const version).
+      const auto& visitor () const
+      {
+        return _visitor;
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) pre (T&& t, Args&&... args)
+      {
+        _subtreeStart.push_back(Clock::now());
+        return profile<T>(ProfilingCallback::pre,[&]() -> decltype(auto) { return _visitor.pre(t,std::forward<Args>(args)...); },args...);
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) in (T&& t, Args&&... args)
+      {
+        return profile<T>(ProfilingCallback::in,[&]() -> decltype(auto) { return _visitor.in(t,std::forward<Args>(args)...); },args...);
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) post (T&& t, Args&&... args)
+      {
+        Clock::time_point start = _subtreeStart.back();
+        _subtreeStart.pop_back();
+        auto treePath = Impl::profilingTreePath(args...);
+        if constexpr (std::is_void_v<decltype(_visitor.post(t,std::forward<Args>(args)...))>) {
+          profile<T>(ProfilingCallback::post,[&]() { _visitor.post(t,std::forward<Args>(args)...); },args...);
+          _profiler->record(ProfilingCallback::subtree,Impl::profilingNodeType<T>(),treePath,start,Clock::now());
+        }
+        else {
+          decltype(auto) result = profile<T>(ProfilingCallback::post,[&]() -> decltype(auto) { return _visitor.post(t,std::forward<Args>(args)...); },args...);
+          _profiler->record(ProfilingCallback::subtree,Impl::profilingNodeType<T>(),treePath,start,Clock::now());
+          return result;
+        }
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) leaf (T&& t, Args&&... args)
+      {
+        return profile<T>(ProfilingCallback::leaf,[&]() -> decltype(auto) { return _visitor.leaf(t,std::forward<Args>(args)...); },args...);
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) beforeChild (T&& t, Args&&... args)
+      {
+        return profile<T>(ProfilingCallback::beforeChild,[&]() -> decltype(auto) { return _visitor.beforeChild(t,std::forward<Args>(args)...); },args...);
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) afterChild (T&& t, Args&&... args)
+      {
+        return profile<T>(ProfilingCallback::afterChild,[&]() -> decltype(auto) { return _visitor.afterChild(t,std::forward<Args>(args)...); },args...);
+      }
+
+      template<typename T, typename... Args>
+      decltype(auto) identical (T&& t, Args&&... args)
+      {
+        return profile<T>(ProfilingCallback::identical,[&]() -> decltype(auto) { return _visitor.identical(t,std::forward<Args>(args)...); },args...);
+      }
+
+    private:
+
+      // Calls f and records its run time under static ids, the tree path is copied after the measurement.
+      template<typename T, typename F, typename... Args>
+      decltype(auto) profile (ProfilingCallback callback, F&& f, const Args&... args)
+      {
+        Clock::time_point start = Clock::now();
+        if constexpr (std::is_void_v<decltype(f())>) {
+          f();
+          Clock::time_point end = Clock::now();
+          _profiler->record(callback,Impl::profilingNodeType<T>(),Impl::profilingTreePath(args...),start,end);
+        }
+        else {
+          decltype(auto) result = f();
+          Clock::time_point end = Clock::now();
+          _profiler->record(callback,Impl::profilingNodeType<T>(),Impl::profilingTreePath(args...),start,end);
+          return result;
+        }
+      }
+
+      V _visitor;
+      Profiler* _profiler;
+      std::vector<Clock::time_point> _subtreeStart;
+    };
+
+    //! Wraps a visitor in a ProfilingVisitor that records its callbacks in profiler.
+    /**
+     * \code
+     * Dune::TypeTree::Profiler profiler(true);
+     * applyToTree(tree,profile(visitor,profiler));
+     * profiler.report(std::cout);
+     * std::ofstream trace("trace.json");
+     * profiler.writeChromeTrace(trace);
+     * \endcode
+     *
+     * \sa ProfilingVisitor
+     */
+    template<typename V>
+    ProfilingVisitor<V> profile (V&& visitor, Profiler& profiler)
+    {
+      return ProfilingVisitor<V>(std::forward<V>(visitor),profiler);
+    }
+
+    //! \} group Tree Traversal
+
+    /** \addtogroup Transformation
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! Mixin base class for transformations that time their node transformation descriptors.
+    /**
+     * If a transformation provides a method profiler() returning a pointer to a Profiler,
+     * TransformTree records the run time of every call of a node transformation descriptor as
+     * callback `transform` or `transform_storage` with the type of the source node. The time
+     * of a descriptor does not include the transformation of the children.
+     *
+     * \code
+     * struct MyTransformation : public Dune::TypeTree::ProfilingTransformation
+     * {
+     *   using ProfilingTransformation::ProfilingTransformation;
+     * };
+     *
+     * Dune::TypeTree::Profiler profiler;
+     * auto transformed = TransformTree<Tree,MyTransformation>::transform(tree,MyTransformation(&profiler));
+     * \endcode
+     */
+    class ProfilingTransformation
+    {
+
+    public:
+
+      explicit ProfilingTransformation (Profiler* profiler = nullptr)
+        : _profiler(profiler)
+      {}
+
+      //! Returns the profiler used for timing the node transformations, may be nullptr.
+      Profiler* profiler () const
+      {
+        return _profiler;
+      }
+
+    private:
+      Profiler* _profiler;
+    };
+
+    //! \} group Transformation
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_PROFILING_HH
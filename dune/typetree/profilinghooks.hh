@@ -0,0 +1,86 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_PROFILINGHOOKS_HH
+#define DUNE_TYPETREE_PROFILINGHOOKS_HH
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Dune {
+  namespace TypeTree {
+
+    // The hooks used by TransformTree to time node transformation descriptors. They only need a
+    // declaration of Profiler, so transformation.hh does not depend on profiling.hh. A
+    // transformation that provides a profiler has included profiling.hh, which completes the
+    // declarations below.
+
+    class Profiler;
+
+    //! Identifies the callback of a measurement recorded by a Profiler.
+    enum class ProfilingCallback
+    {
+      pre, in, post, leaf, beforeChild, afterChild, identical, subtree, transform, transform_storage
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename T>
+      const std::string& profilingNodeName ();
+
+      template<typename Transformation>
+      using HasTransformationProfiler = decltype(std::declval<const Transformation&>().profiler());
+
+      // Transformation descriptor that times the calls of another descriptor.
+      template<typename SourceNode, typename NodeTransformation>
+      struct ProfiledNodeTransformation
+        : public NodeTransformation
+      {
+
+        template<typename Source, typename Transformation, typename... Children>
+        static decltype(auto) transform (Source&& source, Transformation&& transformation, Children&&... children)
+        {
+          return profile(ProfilingCallback::transform,transformation,[&]() -> decltype(auto) {
+              return NodeTransformation::transform(std::forward<Source>(source),transformation,std::forward<Children>(children)...);
+            });
+        }
+
+        template<typename Source, typename Transformation, typename... Children>
+        static decltype(auto) transform_storage (Source&& source, Transformation&& transformation, Children&&... children)
+        {
+          return profile(ProfilingCallback::transform_storage,transformation,[&]() -> decltype(auto) {
+              return NodeTransformation::transform_storage(std::forward<Source>(source),transformation,std::forward<Children>(children)...);
+            });
+        }
+
+      private:
+
+        template<typename Transformation, typename F>
+        static auto profile (ProfilingCallback callback, const Transformation& transformation, F&& f)
+        {
+          auto* profiler = transformation.profiler();
+          if (not profiler)
+            return f();
+          using Clock = typename std::decay_t<decltype(*profiler)>::Clock;
+          typename Clock::time_point start = Clock::now();
+          auto result = f();
+          typename Clock::time_point end = Clock::now();
+          profiler->record(callback,&profilingNodeName<SourceNode>,{},start,end);
+          return result;
+        }
+
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_PROFILINGHOOKS_HH
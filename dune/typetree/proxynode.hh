@@ -24,6 +24,12 @@ namespace Dune {
     template<typename Node>
     class ProxyNode;
 
+#ifndef DOXYGEN
+    namespace Impl {
+      struct WrappedNodeAccess;
+    }
+#endif // DOXYGEN
+
     //! Mixin class providing methods for child access with compile-time parameter.
     template<typename ProxiedNode>
     class StaticChildAccessors
@@ -107,6 +113,21 @@ namespace Dune {
         return node().proxiedNode().template childStorage<k>();
       }
 
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      template<std::size_t k,
+        typename std::enable_if<lazy_enabled<k>::value, int>::type = 0>
+      const auto& childStorageRef (index_constant<k> = {})
+      {
+        return node().proxiedNode().template childStorageRef<k>();
+      }
+
       //! Sets the i-th child to the passed-in value.
       template<std::size_t k, class ProxyChild>
       void setChild (ProxyChild&& child, typename std::enable_if<lazy_enabled<k>::value,void*>::type = 0)
@@ -196,6 +217,21 @@ namespace Dune {
         return node().proxiedNode().childStorage(i);
       }
 
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * In contrast to childStorage(), this does not copy the storage object
+       * and thus avoids the reference count update of the shared_ptr. As the
+       * storage grants mutable access to the child, this method is not
+       * available for const nodes.
+       * \returns a const reference to the object storing the i-th child.
+       */
+      template<bool enabled = !proxiedNodeIsConst,
+        typename std::enable_if<enabled, int>::type = 0>
+      const auto& childStorageRef (std::size_t i)
+      {
+        return node().proxiedNode().childStorageRef(i);
+      }
+
       //! Sets the i-th child to the passed-in value.
       template<class ProxyChild, bool enabled = !proxiedNodeIsConst>
       void setChild (std::size_t i, ProxyChild&& child, typename std::enable_if<enabled,void*>::type = 0)
@@ -265,6 +301,9 @@ namespace Dune {
       friend class StaticChildAccessors<Node>;
       friend class DynamicChildAccessors<Node>;
 
+      // memoryFootprint() needs to follow the storage of the proxied node
+      friend struct Impl::WrappedNodeAccess;
+
     public:
 
       typedef Node ProxiedNode;
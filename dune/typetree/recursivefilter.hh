@@ -0,0 +1,447 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_RECURSIVEFILTER_HH
+#define DUNE_TYPETREE_RECURSIVEFILTER_HH
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/nodeinterface.hh>
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/treepath.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    template<typename Node, typename Predicate, typename TreePath, typename Tag = NodeTag<Node>>
+    class RecursiveFilteredNode;
+
+    namespace Impl {
+
+      // The k-th child of a node with static degree, keeping the constness of Node.
+      template<typename Node, std::size_t k>
+      using FilterChildAt = std::remove_reference_t<decltype(std::declval<Node&>().child(index_constant<k>{}))>;
+
+      // The (uniform) child type of a node with dynamic degree, keeping the constness of Node.
+      template<typename Node>
+      using FilterDynamicChild = std::remove_reference_t<decltype(std::declval<Node&>().child(std::size_t(0)))>;
+
+      // The result type of applying the predicate to a leaf at the given position.
+      template<typename Predicate, typename Leaf, typename TreePath>
+      using FilterPredicateResult = std::decay_t<decltype(std::declval<const Predicate&>()(std::declval<const Leaf&>(),std::declval<TreePath>()))>;
+
+      // Leaves are referenced directly by the view, inner nodes are replaced by filtered views.
+      template<typename Child, typename Predicate, typename TreePath>
+      using FilteredChild = std::conditional_t<Child::isLeaf,
+                                               Child,
+                                               RecursiveFilteredNode<Child,Predicate,TreePath> >;
+
+      // Returns false if it is known at compile time that the subtree does not contain any selected leaf.
+      template<typename Node, typename Predicate, typename TreePath>
+      constexpr bool mayContainSelectedLeaf ()
+      {
+        if constexpr (Node::isLeaf)
+        {
+          using Result = FilterPredicateResult<Predicate,Node,TreePath>;
+          if constexpr (IsIntegralConstant<Result>::value)
+            return Result::value;
+          else
+            return true;
+        }
+        else if constexpr (std::is_same_v<NodeTag<Node>,DynamicPowerNodeTag>)
+        {
+          using ChildPath = decltype(push_back(std::declval<TreePath>(),std::size_t(0)));
+          return mayContainSelectedLeaf<FilterDynamicChild<Node>,Predicate,ChildPath>();
+        }
+        else
+          return unpackIntegerSequence([](auto... k) {
+              return (mayContainSelectedLeaf<FilterChildAt<Node,decltype(k)::value>,
+                                             Predicate,
+                                             decltype(push_back(std::declval<TreePath>(),k))>() || ...);
+            }, std::make_index_sequence<Node::degree()>{});
+      }
+
+      // Compile-time index map of the children of a static node that are retained by the filter.
+      template<typename Node, typename Predicate, typename TreePath>
+      struct FilteredChildIndices
+      {
+        static constexpr std::size_t unfilteredSize = Node::degree();
+
+        static constexpr std::array<bool,unfilteredSize> keep = unpackIntegerSequence([](auto... k) {
+            return std::array<bool,unfilteredSize>{{
+                mayContainSelectedLeaf<FilterChildAt<Node,decltype(k)::value>,
+                                       Predicate,
+                                       decltype(push_back(std::declval<TreePath>(),k))>()...
+              }};
+          }, std::make_index_sequence<unfilteredSize>{});
+
+        static constexpr std::size_t size = [](){
+          std::size_t count = 0;
+          for (bool b : keep)
+            count += b;
+          return count;
+        }();
+
+        static constexpr std::array<std::size_t,size> indices = [](){
+          std::array<std::size_t,size> result{};
+          std::size_t j = 0;
+          for (std::size_t i = 0; i < unfilteredSize; ++i)
+            if (keep[i])
+              result[j++] = i;
+          return result;
+        }();
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! View of a static inner node that recursively removes all subtrees without selected leaves.
+    /**
+     * A RecursiveFilteredNode is a lightweight view on an existing tree: Leaves are referenced
+     * directly, inner nodes are represented by nested views. No node of the underlying tree is
+     * copied, so the view must not outlive the tree it was created from.
+     *
+     * For nodes with a static degree, the set of retained children is computed at compile time.
+     * The view is a composite node containing the children of the original node whose subtree
+     * contains at least one leaf that may be selected by the predicate. Consequently, the
+     * predicate must return a `std::integral_constant` for all leaves that are children of
+     * static nodes.
+     *
+     * \tparam Node       The type of the filtered node, may be const-qualified.
+     * \tparam Predicate  The leaf predicate, see filterTree().
+     * \tparam TreePath   The type of the tree path of this node in the unfiltered tree.
+     */
+    template<typename Node, typename Predicate, typename TreePath, typename Tag>
+    class RecursiveFilteredNode
+    {
+
+      static_assert(not Node::isLeaf, "Leaf nodes cannot be filtered, the filtered tree must start with an inner node");
+
+      typedef Impl::FilteredChildIndices<Node,Predicate,TreePath> Indices;
+
+      template<std::size_t k>
+      using OriginalChild = Impl::FilterChildAt<Node,Indices::indices[k]>;
+
+      template<std::size_t k>
+      using ChildTreePath = decltype(push_back(std::declval<TreePath>(),index_constant<Indices::indices[k]>{}));
+
+      template<std::size_t k>
+      using FilteredChild = Impl::FilteredChild<OriginalChild<k>,Predicate,ChildTreePath<k>>;
+
+      template<std::size_t k>
+      using ChildEntry = std::conditional_t<OriginalChild<k>::isLeaf,
+                                            OriginalChild<k>*,
+                                            FilteredChild<k> >;
+
+      template<std::size_t... k>
+      static std::tuple<ChildEntry<k>...> childEntries (std::index_sequence<k...>);
+
+      typedef decltype(childEntries(std::make_index_sequence<Indices::size>{})) ChildEntries;
+
+    public:
+
+      //! The type tag that describes a CompositeNode.
+      typedef CompositeNodeTag NodeTag;
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a non power in the \ref TypeTree.
+      static const bool isPower = false;
+
+      //! Mark this class as a composite in the \ref TypeTree.
+      static const bool isComposite = true;
+
+      //! The number of children retained by the filter.
+      static constexpr auto degree ()
+      {
+        return std::integral_constant<std::size_t,Indices::size>{};
+      }
+
+      //! Access to the type and the original index of the k-th child.
+      template<std::size_t k>
+      struct Child {
+
+        //! The type of the child.
+        typedef std::remove_const_t<FilteredChild<k>> Type;
+
+        //! The type of the child.
+        typedef Type type;
+
+        //! The index of the child in the unfiltered node.
+        static const std::size_t original_index = Indices::indices[k];
+      };
+
+      //! @name Child Access
+      //! @{
+
+      //! Returns the k-th child.
+      /**
+       * \returns a reference to the original leaf or to the view of the k-th child.
+       */
+      template<std::size_t k>
+      auto& child (index_constant<k> = {})
+      {
+        if constexpr (OriginalChild<k>::isLeaf)
+          return *std::get<k>(_children);
+        else
+          return std::get<k>(_children);
+      }
+
+      //! Returns the k-th child (const version).
+      /**
+       * \returns a const reference to the original leaf or to the view of the k-th child.
+       */
+      template<std::size_t k>
+      const auto& child (index_constant<k> = {}) const
+      {
+        if constexpr (OriginalChild<k>::isLeaf)
+          return *std::get<k>(_children);
+        else
+          return std::get<k>(_children);
+      }
+
+      //! Returns the index of the k-th child in the unfiltered node.
+      template<std::size_t k>
+      static constexpr auto originalIndex (index_constant<k> = {})
+      {
+        return index_constant<Indices::indices[k]>{};
+      }
+
+      //! @}
+
+      //! Returns the unfiltered node.
+      Node& unfiltered ()
+      {
+        return *_node;
+      }
+
+      //! Returns the unfiltered node (const version).
+      const Node& unfiltered () const
+      {
+        return *_node;
+      }
+
+      //! Returns true if the filtered subtree does not contain any leaf.
+      bool empty () const
+      {
+        return unpackIntegerSequence([&](auto... k) {
+            return (childIsEmpty(k) && ...);
+          }, std::make_index_sequence<Indices::size>{});
+      }
+
+      //! Creates a filtered view of node, located at treePath in the unfiltered tree.
+      RecursiveFilteredNode (Node& node, const Predicate& predicate, TreePath treePath = {})
+        : _node(&node)
+        , _children(unpackIntegerSequence([&](auto... k) {
+              return ChildEntries(makeChildEntry(node,predicate,treePath,k)...);
+            }, std::make_index_sequence<Indices::size>{}))
+      {}
+
+    private:
+
+      template<std::size_t k>
+      static ChildEntry<k> makeChildEntry (Node& node, const Predicate& predicate, const TreePath& treePath, index_constant<k>)
+      {
+        auto i = index_constant<Indices::indices[k]>{};
+        if constexpr (OriginalChild<k>::isLeaf)
+        {
+          static_assert(IsIntegralConstant<Impl::FilterPredicateResult<Predicate,OriginalChild<k>,ChildTreePath<k>>>::value,
+                        "The filter predicate must return a std::integral_constant for leaves that are children of static nodes");
+          return &node.child(i);
+        }
+        else
+          return FilteredChild<k>(node.child(i),predicate,push_back(treePath,i));
+      }
+
+      template<std::size_t k>
+      bool childIsEmpty (index_constant<k>) const
+      {
+        if constexpr (OriginalChild<k>::isLeaf)
+          return false;
+        else
+          return std::get<k>(_children).empty();
+      }
+
+      Node* _node;
+      ChildEntries _children;
+    };
+
+
+    //! View of a dynamic power node that recursively removes all subtrees without selected leaves.
+    /**
+     * The children of a DynamicPowerNode are filtered at runtime when the view is created: the view
+     * stores an index map of all children that are selected leaves or whose filtered subtree is not
+     * empty. For leaf children, the predicate may return a plain `bool`.
+     *
+     * \sa RecursiveFilteredNode
+     */
+    template<typename Node, typename Predicate, typename TreePath>
+    class RecursiveFilteredNode<Node,Predicate,TreePath,DynamicPowerNodeTag>
+    {
+
+      typedef Impl::FilterDynamicChild<Node> OriginalChild;
+
+      typedef decltype(push_back(std::declval<TreePath>(),std::size_t(0))) ChildTreePath;
+
+      static const bool leafChildren = OriginalChild::isLeaf;
+
+    public:
+
+      //! The type tag that describes a DynamicPowerNode.
+      typedef DynamicPowerNodeTag NodeTag;
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a power in the \ref TypeTree.
+      static const bool isPower = true;
+
+      //! Mark this class as a non composite in the \ref TypeTree.
+      static const bool isComposite = false;
+
+      //! The type of the children.
+      typedef Impl::FilteredChild<OriginalChild,Predicate,ChildTreePath> ChildType;
+
+      //! The number of children retained by the filter.
+      std::size_t degree () const
+      {
+        return _indices.size();
+      }
+
+      //! @name Child Access
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the original leaf or to the view of the i-th child.
+       */
+      ChildType& child (std::size_t i)
+      {
+        if constexpr (leafChildren)
+          return _node->child(_indices[i]);
+        else
+          return _children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the original leaf or to the view of the i-th child.
+       */
+      const ChildType& child (std::size_t i) const
+      {
+        if constexpr (leafChildren)
+          return _node->child(_indices[i]);
+        else
+          return _children[i];
+      }
+
+      //! Returns the index of the i-th child in the unfiltered node.
+      std::size_t originalIndex (std::size_t i) const
+      {
+        return _indices[i];
+      }
+
+      //! @}
+
+      //! Returns the unfiltered node.
+      Node& unfiltered ()
+      {
+        return *_node;
+      }
+
+      //! Returns the unfiltered node (const version).
+      const Node& unfiltered () const
+      {
+        return *_node;
+      }
+
+      //! Returns true if the filtered subtree does not contain any leaf.
+      bool empty () const
+      {
+        return _indices.empty();
+      }
+
+      //! Creates a filtered view of node, located at treePath in the unfiltered tree.
+      RecursiveFilteredNode (Node& node, const Predicate& predicate, TreePath treePath = {})
+        : _node(&node)
+      {
+        if constexpr (Impl::mayContainSelectedLeaf<OriginalChild,Predicate,ChildTreePath>())
+          for (std::size_t i = 0; i < node.degree(); ++i)
+          {
+            auto childTreePath = push_back(treePath,i);
+            if constexpr (leafChildren)
+            {
+              if (predicate(std::as_const(node.child(i)),childTreePath))
+                _indices.push_back(i);
+            }
+            else
+            {
+              ChildType childView(node.child(i),predicate,childTreePath);
+              if (not childView.empty())
+              {
+                _indices.push_back(i);
+                _children.push_back(std::move(childView));
+              }
+            }
+          }
+      }
+
+    private:
+      Node* _node;
+      std::vector<std::size_t> _indices;
+      // views of the retained children, not needed if the children are leaves
+      std::conditional_t<leafChildren,std::tuple<>,std::vector<ChildType>> _children;
+    };
+
+
+    //! Creates a recursively filtered view of a tree.
+    /**
+     * The returned view contains all leaves of the tree that are selected by the predicate, together
+     * with the inner nodes on the paths to these leaves. Subtrees without any selected leaf are
+     * removed. The predicate is invoked as `predicate(leaf,treePath)` with the leaf and its tree
+     * path in the unfiltered tree, and it is only ever applied to leaves:
+     *
+     * - If it returns a `std::integral_constant`, the decision is made at compile time and static
+     *   subtrees without selected leaves do not appear in the type of the view at all.
+     * - If it returns a `bool`, the decision is made at runtime. This is only possible for leaves
+     *   that are children of a DynamicPowerNode, whose filtered views store an index map of the
+     *   retained children.
+     *
+     * The view does not copy any nodes: leaves are returned by reference and inner nodes are
+     * represented by RecursiveFilteredNode objects that point to the original nodes. It can be
+     * traversed like any other tree, e.g. with applyToTree().
+     *
+     * \param tree       The tree to filter, must not be a leaf and must outlive the view.
+     * \param predicate  The leaf predicate.
+     */
+    template<typename Tree, typename Predicate>
+    auto filterTree (Tree& tree, const Predicate& predicate)
+    {
+      return RecursiveFilteredNode<Tree,Predicate,HybridTreePath<>>(tree,predicate,HybridTreePath<>{});
+    }
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_RECURSIVEFILTER_HH
@@ -8,10 +8,12 @@
 
 #include <array>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <dune/typetree/nodeinterface.hh>
 #include <dune/typetree/nodetags.hh>
+#include <dune/typetree/memoryresource.hh>
 #include <dune/common/exceptions.hh>
 
 
@@ -23,6 +25,51 @@ namespace Dune {
      *  \{
      */
 
+    //! Transformation descriptor that leaves a node and its subtree unchanged.
+    /**
+     * The descriptor can be registered for any kind of node. As it declares itself to be the
+     * identity, the transformation engine does not transform the subtree of the node at all, but
+     * shares the storage of the source node with the transformed parent node. Only if the node is
+     * the root of the transformed tree, it is copied, which shares the children with the source.
+     * The transformed tree grants mutable access to the shared subtrees, even if the source tree
+     * was passed as const, so modifying them through the transformed tree changes the source tree.
+     *
+     * Other descriptors can opt into this behavior by declaring `static const bool identity = true`,
+     * which asserts that they leave the node and its whole subtree unchanged. Recursive descriptors
+     * that build the transformed node from its transformed children alone, like
+     * SimplePowerNodeTransformation, declare `static const bool stateless = true`. The engine then
+     * also shares their subtree if they rebuild the source node type from children that are all
+     * shared. Other descriptors that rebuild the source node type are still called.
+     */
+    template<typename SourceNode, typename Transformation>
+    struct IdentityNodeTransformation
+    {
+
+      static const bool recursive = false;
+
+      static const bool identity = true;
+
+      typedef SourceNode transformed_type;
+      typedef std::shared_ptr<transformed_type> transformed_storage_type;
+
+      static transformed_type transform(const SourceNode& s, const Transformation& t)
+      {
+        return s;
+      }
+
+      static transformed_type transform(std::shared_ptr<const SourceNode> s, const Transformation& t)
+      {
+        return *s;
+      }
+
+      static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
+      {
+        return makeNodeStorage<transformed_type>(t,*s);
+      }
+
+    };
+
+
     template<typename SourceNode, typename Transformation, typename TransformedNode>
     struct SimpleLeafNodeTransformation
     {
@@ -39,7 +86,7 @@ namespace Dune {
 
       static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
       {
-        return std::make_shared<transformed_type>();
+        return makeNodeStorage<transformed_type>(t);
       }
 
     };
@@ -51,6 +98,8 @@ namespace Dune {
 
       static const bool recursive = true;
 
+      static const bool stateless = true;
+
       template<typename TC>
       struct result
       {
@@ -68,7 +117,7 @@ namespace Dune {
       template<typename TC>
       static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::array<std::shared_ptr<TC>,result<TC>::degree>& children)
       {
-        return std::make_shared<typename result<TC>::type>(children);
+        return makeNodeStorage<typename result<TC>::type>(t,children);
       }
 
     };
@@ -80,6 +129,8 @@ namespace Dune {
 
       static const bool recursive = true;
 
+      static const bool stateless = true;
+
       template<typename TC>
       struct result
       {
@@ -96,7 +147,7 @@ namespace Dune {
       template<typename TC>
       static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, const std::vector<std::shared_ptr<TC>>& children)
       {
-        return std::make_shared<typename result<TC>::type>(children);
+        return makeNodeStorage<typename result<TC>::type>(t,children);
       }
 
     };
@@ -108,6 +159,8 @@ namespace Dune {
 
       static const bool recursive = true;
 
+      static const bool stateless = true;
+
       template<typename... TC>
       struct result
       {
@@ -124,7 +177,123 @@ namespace Dune {
       template<typename... TC>
       static typename result<TC...>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, std::shared_ptr<TC>... children)
       {
-        return std::make_shared<typename result<TC...>::type>(children...);
+        return makeNodeStorage<typename result<TC...>::type>(t,std::move(children)...);
+      }
+
+    };
+
+
+    //! Leaf node transformation that stores the transformed node in a std::unique_ptr.
+    /**
+     * The SimpleUnique*NodeTransformation descriptors mirror their shared counterparts, but
+     * produce trees with unique ownership of all children, like e.g. UniquePowerNode or
+     * UniqueCompositeNode. The transformed children are moved into the new node.
+     */
+    template<typename SourceNode, typename Transformation, typename TransformedNode>
+    struct SimpleUniqueLeafNodeTransformation
+    {
+
+      static const bool recursive = false;
+
+      typedef TransformedNode transformed_type;
+      typedef std::unique_ptr<transformed_type> transformed_storage_type;
+
+      static transformed_type transform(const SourceNode& s, const Transformation& t)
+      {
+        return transformed_type();
+      }
+
+      static transformed_storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t)
+      {
+        return std::make_unique<transformed_type>();
+      }
+
+    };
+
+
+    //! Power node transformation that stores the transformed node in a std::unique_ptr.
+    template<typename SourceNode, typename Transformation, template<typename Child, std::size_t> class TransformedNode>
+    struct SimpleUniquePowerNodeTransformation
+    {
+
+      static const bool recursive = true;
+
+      template<typename TC>
+      struct result
+      {
+        typedef TransformedNode<TC, StaticDegree<SourceNode>::value> type;
+        typedef std::unique_ptr<type> storage_type;
+        static const std::size_t degree = StaticDegree<type>::value;
+      };
+
+      template<typename TC>
+      static typename result<TC>::type transform(const SourceNode& s, const Transformation& t, std::array<std::unique_ptr<TC>,result<TC>::degree> children)
+      {
+        return typename result<TC>::type(std::move(children));
+      }
+
+      template<typename TC>
+      static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, std::array<std::unique_ptr<TC>,result<TC>::degree> children)
+      {
+        return std::make_unique<typename result<TC>::type>(std::move(children));
+      }
+
+    };
+
+
+    //! Dynamic power node transformation that stores the transformed node in a std::unique_ptr.
+    template<typename SourceNode, typename Transformation, template<typename Child> class TransformedNode>
+    struct SimpleUniqueDynamicPowerNodeTransformation
+    {
+
+      static const bool recursive = true;
+
+      template<typename TC>
+      struct result
+      {
+        typedef TransformedNode<TC> type;
+        typedef std::unique_ptr<type> storage_type;
+      };
+
+      template<typename TC>
+      static typename result<TC>::type transform(const SourceNode& s, const Transformation& t, std::vector<std::unique_ptr<TC>> children)
+      {
+        return typename result<TC>::type(std::move(children));
+      }
+
+      template<typename TC>
+      static typename result<TC>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, std::vector<std::unique_ptr<TC>> children)
+      {
+        return std::make_unique<typename result<TC>::type>(std::move(children));
+      }
+
+    };
+
+
+    //! Composite node transformation that stores the transformed node in a std::unique_ptr.
+    template<typename SourceNode, typename Transformation, template<typename...> class TransformedNode>
+    struct SimpleUniqueCompositeNodeTransformation
+    {
+
+      static const bool recursive = true;
+
+      template<typename... TC>
+      struct result
+      {
+        typedef TransformedNode<TC...> type;
+        typedef std::unique_ptr<type> storage_type;
+      };
+
+      template<typename... TC>
+      static typename result<TC...>::type transform(const SourceNode& s, const Transformation& t, std::unique_ptr<TC>... children)
+      {
+        return typename result<TC...>::type(std::move(children)...);
+      }
+
+      template<typename... TC>
+      static typename result<TC...>::storage_type transform_storage(std::shared_ptr<const SourceNode> s, const Transformation& t, std::unique_ptr<TC>... children)
+      {
+        return std::make_unique<typename result<TC...>::type>(std::move(children)...);
       }
 
     };
@@ -7,13 +7,20 @@
 #define DUNE_TYPETREE_TRANSFORMATION_HH
 
 #include <array>
+#include <concepts>
 #include <tuple>
 #include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <dune/common/hybridutilities.hh>
 #include <dune/common/exceptions.hh>
+#include <dune/common/indices.hh>
 #include <dune/common/typetraits.hh>
+#include <dune/common/std/type_traits.hh>
+#include <dune/typetree/memoryresource.hh>
+#include <dune/typetree/profilinghooks.hh>
 #include <dune/typetree/typetraits.hh>
 #include <dune/typetree/nodeinterface.hh>
 #include <dune/typetree/nodetags.hh>
@@ -73,441 +80,337 @@ namespace Dune {
 
       typedef typename evaluate_if_meta_function<
         lookup_type
-        >::type type;
+        >::type descriptor_type;
 
-      static_assert((!std::is_same<type,void>::value), "Unable to find valid transformation descriptor");
-    };
-
-#endif // DOXYGEN
-
-
-    //! Transform a TypeTree.
-    /**
-     * This struct can be used to apply a transformation to a given TypeTree. It exports the type of
-     * the resulting (transformed) tree and contains methods to actually transform tree instances.
-     *
-     * \tparam SourceTree     = The TypeTree that should be transformed.
-     * \tparam Transformation = The Transformation to apply to the TypeTree.
-     * \tparam Tag            = This parameter is an implementation detail and must always be set to its default value.
-     * \tparam recursive      = This parameter is an implementation detail and must always be set to its default value.
-     */
-    template<typename SourceTree, typename Transformation, typename Tag = StartTag, bool recursive = true>
-    struct TransformTree
-    {
+      static_assert((!std::is_same<descriptor_type,void>::value), "Unable to find valid transformation descriptor");
 
-#ifndef DOXYGEN
-
-      typedef typename LookupNodeTransformation<SourceTree,Transformation,typename SourceTree::ImplementationTag>::type NodeTransformation;
-
-      // the type of the new tree that will result from this transformation
-      typedef typename TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transformed_type transformed_type;
-
-      // the storage type of the new tree that will result from this transformation
-      typedef typename TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transformed_storage_type transformed_storage_type;
+      // time the descriptor if the transformation provides a profiler
+      typedef std::conditional_t<
+        Std::is_detected_v<Impl::HasTransformationProfiler,T>,
+        Impl::ProfiledNodeTransformation<S,descriptor_type>,
+        descriptor_type
+        > type;
+    };
 
 #endif // DOXYGEN
 
-      //! The type of the transformed tree.
-      typedef transformed_type type;
-
-      typedef type Type;
-
-      //! Apply transformation to an existing tree s.
-      static transformed_type transform(const SourceTree& s, const Transformation& t = Transformation())
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform(s,t);
-      }
-
-      //! Apply transformation to an existing tree s.
-      static transformed_type transform(const SourceTree& s, Transformation& t)
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform(s,t);
-      }
-
-      //! Apply transformation to an existing tree s.
-      static transformed_type transform(std::shared_ptr<const SourceTree> sp, const Transformation& t = Transformation())
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform(sp,t);
-      }
-
-      //! Apply transformation to an existing tree s.
-      static transformed_type transform(std::shared_ptr<const SourceTree> sp, Transformation& t)
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform(sp,t);
-      }
 
-      //! Apply transformation to storage type of an existing tree, returning a heap-allocated storage type
-      //! instance of the transformed tree.
-      static transformed_storage_type transform_storage(std::shared_ptr<const SourceTree> sp, const Transformation& t = Transformation())
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform_storage(sp,t);
-      }
+#ifndef DOXYGEN // internal per-node implementation of the transformation algorithm
 
-      //! Apply transformation to storage type of an existing tree, returning a heap-allocated storage type
-      //! instance of the transformed tree.
-      static transformed_storage_type transform_storage(std::shared_ptr<const SourceTree> sp, Transformation& t)
-      {
-        return TransformTree<SourceTree,Transformation,NodeTag<SourceTree>,NodeTransformation::recursive>::transform_storage(sp,t);
-      }
+    namespace Impl {
 
+      // The transformation descriptor for the source node S.
+      template<typename S, typename T>
+      using NodeTransformation = typename LookupNodeTransformation<S,T,ImplementationTag<S>>::type;
 
-    };
+      template<typename S>
+      concept PowerTransformationSource = std::same_as<NodeTag<S>,PowerNodeTag> or std::same_as<NodeTag<S>,DynamicPowerNodeTag>;
 
-#ifndef DOXYGEN // internal per-node implementations of the transformation algorithm
+      template<typename S>
+      concept CompositeTransformationSource = std::same_as<NodeTag<S>,CompositeNodeTag>;
 
-    // handle a leaf node - this is easy
-    template<typename S, typename T, bool recursive>
-    struct TransformTree<S,T,LeafNodeTag,recursive>
-    {
-      // get transformed type from specification
-      typedef typename LookupNodeTransformation<S,T,ImplementationTag<S>>::type NodeTransformation;
+      // Checks whether the descriptor of S expects the transformed children. Descriptors of leaf
+      // nodes are never recursive.
+      template<typename S, typename T>
+      concept RecursiveTransformation = (PowerTransformationSource<S> or CompositeTransformationSource<S>)
+        and NodeTransformation<S,T>::recursive;
 
-      typedef typename NodeTransformation::transformed_type transformed_type;
-      typedef typename NodeTransformation::transformed_storage_type transformed_storage_type;
+      template<typename S, typename T>
+      struct TransformNode;
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(const S& s, T& t)
+      // The types of the transformed node, taken directly from the descriptor for non-recursive
+      // transformations.
+      template<typename S, typename T>
+      struct TransformedNodeTypes
       {
-        return NodeTransformation::transform(s,t);
-      }
-
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(const S& s, const T& t)
-      {
-        return NodeTransformation::transform(s,t);
-      }
-
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(std::shared_ptr<const S> sp, T& t)
-      {
-        return NodeTransformation::transform(sp,t);
-      }
+        using type = typename NodeTransformation<S,T>::transformed_type;
+        using storage_type = typename NodeTransformation<S,T>::transformed_storage_type;
+      };
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(std::shared_ptr<const S> sp, const T& t)
+      // The transformed power node is parameterized on the transformed child type, so the
+      // descriptor provides an inner template result<> that is passed the transformed child type.
+      // As all children have the same type, the child type only has to be transformed once.
+      template<typename S, typename T>
+        requires RecursiveTransformation<S,T> and PowerTransformationSource<S>
+      struct TransformedNodeTypes<S,T>
       {
-        return NodeTransformation::transform(sp,t);
-      }
+        using Result = typename NodeTransformation<S,T>::template result<typename TransformNode<typename S::ChildType,T>::transformed_type>;
+        using type = typename Result::type;
+        using storage_type = typename Result::storage_type;
+      };
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, T& t)
-      {
-        return NodeTransformation::transform_storage(sp,t);
-      }
+      // Extracts the types of all children from ChildTypes, as the source node will usually be a
+      // derived type with more template arguments than just the children.
+      template<typename NT, typename T, typename ChildTypes>
+      struct TransformedCompositeResult;
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, const T& t)
+      template<typename NT, typename T, typename... C>
+      struct TransformedCompositeResult<NT,T,std::tuple<C...>>
       {
-        return NodeTransformation::transform_storage(sp,t);
-      }
-
-    };
-
-
-    // common implementation for non-recursive transformation of non-leaf nodes
-    template<typename S, typename T>
-    struct TransformTreeNonRecursive
-    {
-      // get transformed type from specification
-      typedef typename LookupNodeTransformation<S,T,ImplementationTag<S>>::type NodeTransformation;
-
-      typedef typename NodeTransformation::transformed_type transformed_type;
-      typedef typename NodeTransformation::transformed_storage_type transformed_storage_type;
+        using type = typename NT::template result<typename TransformNode<C,T>::transformed_type...>;
+      };
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(const S& s, T& t)
+      template<typename S, typename T>
+        requires RecursiveTransformation<S,T> and CompositeTransformationSource<S>
+      struct TransformedNodeTypes<S,T>
       {
-        return NodeTransformation::transform(s,t);
-      }
+        using Result = typename TransformedCompositeResult<NodeTransformation<S,T>,T,typename S::ChildTypes>::type;
+        using type = typename Result::type;
+        using storage_type = typename Result::storage_type;
+      };
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(const S& s, const T& t)
-      {
-        return NodeTransformation::transform(s,t);
-      }
+      // Checks whether the descriptor of S declares itself to be the identity, see
+      // IdentityNodeTransformation. The transformed subtree rooted in S is then identical to the
+      // source subtree, so the transformation can share the source storage instead of rebuilding
+      // the subtree.
+      template<typename S, typename T>
+      concept IdentityTransformation = requires { requires bool(NodeTransformation<S,T>::identity); };
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(std::shared_ptr<const S> sp, T& t)
-      {
-        return NodeTransformation::transform(sp,t);
-      }
+      // Checks whether the descriptor of S declares itself to be stateless, i.e. it builds the
+      // transformed node from the transformed children alone, like SimplePowerNodeTransformation.
+      template<typename S, typename T>
+      concept StatelessTransformation = requires { requires bool(NodeTransformation<S,T>::stateless); };
 
-      // delegate instance transformation to per-node specification
-      static transformed_type transform(std::shared_ptr<const S> sp, const T& t)
-      {
-        return NodeTransformation::transform(sp,t);
-      }
+      template<typename S, typename T>
+      struct PreservesSubtree;
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, T& t)
-      {
-        return NodeTransformation::transform_storage(sp,t);
-      }
+      template<typename T, typename ChildTypes>
+      struct PreservesChildren;
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, const T& t)
-      {
-        return NodeTransformation::transform_storage(sp,t);
-      }
+      template<typename T, typename... C>
+      struct PreservesChildren<T,std::tuple<C...>>
+        : std::conjunction<PreservesSubtree<C,T>...>
+      {};
 
-    };
+      template<typename S, typename T>
+      using RebuildsSourceNode = std::conjunction<
+        std::is_same<typename TransformedNodeTypes<S,T>::type,S>,
+        std::is_same<typename TransformedNodeTypes<S,T>::storage_type,std::shared_ptr<S>>
+        >;
+
+      // Checks whether the transformed subtree rooted in S is identical to the source subtree.
+      // This is the case if the descriptor of S is the identity, or if a stateless descriptor
+      // rebuilds the source node type in shared storage from children that are all preserved.
+      // The engine does not infer it for other descriptors, as they may rebuild the same node
+      // type with different state.
+      template<typename S, typename T>
+      struct PreservesSubtree
+        : std::bool_constant<IdentityTransformation<S,T>>
+      {};
 
+      template<typename S, typename T>
+        requires StatelessTransformation<S,T> and RecursiveTransformation<S,T> and PowerTransformationSource<S> and (not IdentityTransformation<S,T>)
+      struct PreservesSubtree<S,T>
+        : std::conjunction<RebuildsSourceNode<S,T>,PreservesSubtree<typename S::ChildType,T>>
+      {};
 
-    namespace Impl {
+      template<typename S, typename T>
+        requires StatelessTransformation<S,T> and RecursiveTransformation<S,T> and CompositeTransformationSource<S> and (not IdentityTransformation<S,T>)
+      struct PreservesSubtree<S,T>
+        : std::conjunction<RebuildsSourceNode<S,T>,PreservesChildren<T,typename S::ChildTypes>>
+      {};
 
-      // Helper class to handle recursive power nodes
-      template<class Source, class Transformation, class Tag>
-      class RecursivePowerTransformTree
+      // Transforms a single node of type S with transformation T. The children of a recursive
+      // transformation are transformed first, in the order of their indices, and their storage is
+      // passed to the descriptor: as a std::array or std::vector for power nodes and as separate
+      // arguments for composite nodes. Preserved subtrees are not transformed at all: Their
+      // storage is shared with the source tree, or the root of the subtree is copied.
+      template<typename S, typename T>
+      struct TransformNode
       {
-        // We only know two types of tags!
-        static_assert(std::is_same_v<Tag,PowerNodeTag> or std::is_same_v<Tag,DynamicPowerNodeTag>);
+        using Descriptor = NodeTransformation<S,T>;
+        using transformed_type = typename TransformedNodeTypes<S,T>::type;
+        using transformed_storage_type = typename TransformedNodeTypes<S,T>::storage_type;
 
-        using ChildType = typename Source::ChildType;
+        static_assert(not IdentityTransformation<S,T> or std::is_same_v<transformed_type,S>,
+                      "An identity transformation descriptor must not change the node type");
 
-        // in case degree is dynamic, provid a vector correctly initialized
-        template<class NodeStorage>
-        static auto node_storage_provider(const std::size_t& degree)
+        template<typename Trafo>
+        static auto transformChildren(const S& s, Trafo& t)
         {
-          return std::vector<NodeStorage>(degree);
-        }
-
-        // in case degree is static, provid an array
-        template<class NodeStorage, class StaticIndex>
-        static auto node_storage_provider(StaticIndex)
-        {
-          return std::array<NodeStorage,std::size_t(StaticIndex{})>();
-        }
-
-      public:
-        // get transformed type from specification
-        // Handling this transformation in a way that makes the per-node specification easy to write
-        // is a little involved:
-        // The problem is that the transformed power node must be parameterized on the transformed child
-        // type. So we need to transform the child type and pass the transformed child type to an inner
-        // template of the node transformation struct called result (see example of such a specification
-        // further down).
-        using NodeTransformation = typename LookupNodeTransformation<Source,Transformation,ImplementationTag<Source>>::type;
-        using ChildNodeTransformation = typename LookupNodeTransformation<ChildType,Transformation,ImplementationTag<ChildType>>::type;
-
-      private:
-        // Since every child is same type, is enough to get transformation once
-        using ChildTreeTransformation = TransformTree<ChildType,
-                                                      Transformation,
-                                                      NodeTag<ChildType>,
-                                                      ChildNodeTransformation::recursive>;
-
-        // Get transformed type of children
-        using transformed_child_type = typename ChildTreeTransformation::transformed_type;
-        using transformed_child_storage_type = typename ChildTreeTransformation::transformed_storage_type;
-      public:
-        // Apply transformation from children to current node
-        using transformed_type = typename NodeTransformation::template result<transformed_child_type>::type;
-        using transformed_storage_type = typename NodeTransformation::template result<transformed_child_type>::storage_type;
-
-        // Transform an instance of source tree.
-        static transformed_type transform(const Source& source, Transformation& transformation)
-        {
-          auto children_storage = node_storage_provider<std::shared_ptr<transformed_child_type>>(source.degree());
-          for (std::size_t k = 0; k < source.degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source.childStorage(k),transformation);
+          if constexpr (PowerTransformationSource<S>) {
+            using Child = TransformNode<typename S::ChildType,T>;
+            auto storage = [&]{
+              if constexpr (IsIntegralConstant<decltype(s.degree())>::value)
+                return std::array<typename Child::transformed_storage_type,S::degree()>();
+              else
+                return std::vector<typename Child::transformed_storage_type>(s.degree());
+            }();
+            for (std::size_t k = 0; k < s.degree(); ++k)
+              storage[k] = transformChild<typename S::ChildType>(s,k,t);
+            return storage;
           }
-          return NodeTransformation::transform(source,transformation,children_storage);
+          else
+            return unpackIntegerSequence([&](auto... i) {
+              // list-initialization evaluates the children from left to right
+              return std::tuple<typename TransformNode<typename S::template Child<i>::Type,T>::transformed_storage_type...>{
+                transformChild<typename S::template Child<i>::Type>(s,i,t)...
+              };
+            }, std::make_index_sequence<S::degree()>());
         }
 
-        // Transform an instance of source tree.
-        static transformed_type transform(const Source& source, const Transformation& transformation)
+        // Transforms the child with index i, sharing the source storage of a preserved subtree.
+        // Nodes that own their children uniquely or by value do not provide childStorage(), so
+        // their children are transformed by reference and never passed to descriptors as storage.
+        template<typename Child, typename Index, typename Trafo>
+        static auto transformChild(const S& s, Index i, Trafo& t)
         {
-          auto children_storage = node_storage_provider<std::shared_ptr<transformed_child_type>>(source.degree());
-          for (std::size_t k = 0; k < source.degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source.childStorage(k),transformation);
-          }
-          return NodeTransformation::transform(source,transformation,children_storage);
+          using Storage = typename TransformNode<Child,T>::transformed_storage_type;
+          using Transformed = typename TransformNode<Child,T>::transformed_type;
+          if constexpr (PreservesSubtree<Child,T>::value and requires { { std::const_pointer_cast<Child>(s.childStorage(i)) } -> std::convertible_to<Storage>; })
+            // the transformed tree shares the subtree with the source and may modify it
+            return Storage(std::const_pointer_cast<Child>(s.childStorage(i)));
+          else if constexpr (requires { s.childStorage(i); })
+            return TransformNode<Child,T>::transform_storage(s.childStorage(i),t);
+          else if constexpr (std::is_same_v<Storage,std::unique_ptr<Transformed>>)
+            return std::make_unique<Transformed>(TransformNode<Child,T>::transform(s.child(i),t));
+          else
+            return makeNodeStorage<Transformed>(t,TransformNode<Child,T>::transform(s.child(i),t));
         }
 
-        // Transform an instance of source tree.
-        static transformed_type transform(std::shared_ptr<const Source> source_ptr, Transformation& transformation)
+        template<typename Trafo>
+        static transformed_type transform(const S& s, Trafo& t)
         {
-          auto children_storage = node_storage_provider<std::shared_ptr<transformed_child_type>>(source_ptr->degree());
-          for (std::size_t k = 0; k < source_ptr->degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source_ptr->childStorage(k),transformation);
+          if constexpr (not RecursiveTransformation<S,T>)
+            return Descriptor::transform(s,t);
+          else if constexpr (PreservesSubtree<S,T>::value)
+            return s;
+          else {
+            auto children = transformChildren(s,t);
+            if constexpr (PowerTransformationSource<S>)
+              return Descriptor::transform(s,t,std::move(children));
+            else
+              return std::apply([&](auto&... c) {
+                  return Descriptor::transform(s,t,std::move(c)...);
+                }, children);
           }
-          return NodeTransformation::transform(source_ptr,transformation,children_storage);
         }
 
-        // Transform an instance of source tree.
-        static transformed_type transform(std::shared_ptr<const Source> source_ptr, const Transformation& transformation)
+        template<typename Trafo>
+        static transformed_type transform(std::shared_ptr<const S> sp, Trafo& t)
         {
-          auto children_storage = node_storage_provider<std::shared_ptr<transformed_child_type>>(source_ptr->degree());
-          for (std::size_t k = 0; k < source_ptr->degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source_ptr->childStorage(k),transformation);
+          if constexpr (not RecursiveTransformation<S,T>)
+            return Descriptor::transform(std::move(sp),t);
+          else if constexpr (PreservesSubtree<S,T>::value)
+            return *sp;
+          else {
+            auto children = transformChildren(*sp,t);
+            if constexpr (PowerTransformationSource<S>)
+              return Descriptor::transform(std::move(sp),t,std::move(children));
+            else
+              return std::apply([&](auto&... c) {
+                  return Descriptor::transform(std::move(sp),t,std::move(c)...);
+                }, children);
           }
-          return NodeTransformation::transform(source_ptr,transformation,children_storage);
         }
 
-        // Transform an instance of source tree ptr.
-        static transformed_storage_type transform_storage(std::shared_ptr<const Source> source_ptr, Transformation& transformation)
+        template<typename Trafo>
+        static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, Trafo& t)
         {
-          auto children_storage = node_storage_provider<transformed_child_storage_type>(source_ptr->degree());
-          for (std::size_t k = 0; k < source_ptr->degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source_ptr->childStorage(k),transformation);
+          if constexpr (not RecursiveTransformation<S,T>)
+            return Descriptor::transform_storage(std::move(sp),t);
+          else if constexpr (PreservesSubtree<S,T>::value)
+            return makeNodeStorage<S>(t,*sp);
+          else {
+            auto children = transformChildren(*sp,t);
+            if constexpr (PowerTransformationSource<S>)
+              return Descriptor::transform_storage(std::move(sp),t,std::move(children));
+            else
+              return std::apply([&](auto&... c) {
+                  return Descriptor::transform_storage(std::move(sp),t,std::move(c)...);
+                }, children);
           }
-          return NodeTransformation::transform_storage(source_ptr,transformation,children_storage);
         }
-
-        // Transform an instance of source tree ptr.
-        static transformed_storage_type transform_storage(std::shared_ptr<const Source> source_ptr, const Transformation& transformation)
-        {
-          auto children_storage = node_storage_provider<transformed_child_storage_type>(source_ptr->degree());
-          for (std::size_t k = 0; k < source_ptr->degree(); ++k) {
-            children_storage[k] = ChildTreeTransformation::transform_storage(source_ptr->childStorage(k),transformation);
-          }
-          return NodeTransformation::transform_storage(source_ptr,transformation,children_storage);
-        }
-
       };
+
     } // namespace Impl
 
-    // Recursive version of the PowerNode transformation for static nodes.
-    template<typename Source, typename Transformation>
-    struct TransformTree<Source,Transformation,PowerNodeTag,true>
-      : public Impl::RecursivePowerTransformTree<Source,Transformation,PowerNodeTag>
-    {};
-
-    // Recursive version of the DynamicPowerNode transformation for static nodes.
-    template<typename Source, typename Transformation>
-    struct TransformTree<Source,Transformation,DynamicPowerNodeTag,true>
-      : public Impl::RecursivePowerTransformTree<Source,Transformation,DynamicPowerNodeTag>
-    {};
-
-    // non-recursive version of the PowerNode transformation.
-    template<typename S, typename T>
-    struct TransformTree<S,T,PowerNodeTag,false>
-      : public TransformTreeNonRecursive<S,T>
-    {};
-
-    // non-recursive version of the DynamicPowerNodeTag transformation.
-    template<typename S, typename T>
-    struct TransformTree<S,T,DynamicPowerNodeTag,false>
-      : public TransformTreeNonRecursive<S,T>
-    {};
-
-    // helper struct that does the actual transformation for a composite node. We need this additional struct
-    // to extract the template argument list with the types of all children from the node, which we cannot do
-    // directly in the transformation<> template, as the type passed to transformation<> will usually be a
-    // derived type and will normally have more template arguments than just the children. This declaration
-    // just introduces the type of the helper struct, we always instantiate the specialization defined below;
-    template<typename S, typename Children, typename T>
-    struct transform_composite_node;
-
-    // specialized version of the helper struct which extracts the template argument list with the children from
-    // its second template parameter, which has to be CompositeNode::ChildTypes. Apart from that, the struct is
-    // similar to the one for a PowerNode, but it obviously delegates transformation of the children to the TMP.
-    template<typename S, typename T, typename... C>
-    struct transform_composite_node<S,std::tuple<C...>,T>
+#endif // DOXYGEN
+
+    //! Transform a TypeTree.
+    /**
+     * This struct can be used to apply a transformation to a given TypeTree. It exports the type of
+     * the resulting (transformed) tree and contains methods to actually transform tree instances.
+     * If the Transformation provides a Profiler (see ProfilingTransformation), the run time of each
+     * node transformation descriptor is recorded.
+     *
+     * The children of nodes that own them uniquely or by value, like UniquePowerNode and
+     * ValuePowerNode, have no shared storage. They are transformed with the reference overload
+     * transform(const SourceNode&) of their descriptors, even by transform_storage(). Like any tree
+     * obtained from that overload, the transformed tree must not outlive such a source tree if its
+     * nodes refer to the source nodes.
+     *
+     * \tparam SourceTree     = The TypeTree that should be transformed.
+     * \tparam Transformation = The Transformation to apply to the TypeTree.
+     * \tparam Tag            = This parameter is ignored and only kept for backwards compatibility.
+     * \tparam recursive      = This parameter is only kept for backwards compatibility and must be
+     *                          `true`. Whether a node is transformed recursively is determined by
+     *                          its transformation descriptor.
+     */
+    template<typename SourceTree, typename Transformation, typename Tag = StartTag, bool recursive = true>
+    struct TransformTree
     {
 
-      // transformed type, using the same nested struct trick as the PowerNode
-      typedef ImplementationTag<S> Tag;
-      typedef typename LookupNodeTransformation<S,T,Tag>::type NodeTransformation;
-      typedef typename NodeTransformation::template result<typename TransformTree<C,
-                                                                                  T,
-                                                                                  NodeTag<C>,
-                                                                                  LookupNodeTransformation<C,T,ImplementationTag<C>>::type::recursive
-                                                                                  >::transformed_type...
-                                                           >::type transformed_type;
-
-      typedef typename NodeTransformation::template result<typename TransformTree<C,
-                                                                                  T,
-                                                                                  NodeTag<C>,
-                                                                                  LookupNodeTransformation<C,T,ImplementationTag<C>>::type::recursive
-                                                                                  >::transformed_type...
-                                                           >::storage_type transformed_storage_type;
-
-      // Retrieve the transformation descriptor for the child with index i.
-      // This little helper improves really improves the readability of the
-      // transformation functions.
-      template<std::size_t i>
-      struct ChildTransformation
-        : public TransformTree<typename S::template Child<i>::Type,
-                               T,
-                               NodeTag<typename S::template Child<i>::Type>,
-                               LookupNodeTransformation<
-                                 typename S::template Child<i>::Type,
-                                 T,
-                                 ImplementationTag<typename S::template Child<i>::Type>
-                                 >::type::recursive
-                               >
-      {};
+      static_assert(recursive, "TransformTree does not support recursive = false, use a descriptor with recursive = false instead");
 
-      template<std::size_t i, typename Tuple, typename Value>
-      static void setElement(Tuple& tuple, Value&& value)
-      {
-        std::get<i>(tuple) = std::forward<Value>(value);
-      }
+#ifndef DOXYGEN
 
-      template<typename Trafo, std::size_t... i>
-      static transformed_type transform(const S& s, Trafo&& t, std::index_sequence<i...> indices)
-      {
-        std::tuple<typename ChildTransformation<i>::transformed_storage_type...> storage;
-        Dune::Hybrid::Impl::evaluateFoldExpression<int>({(setElement<i>(storage, ChildTransformation<i>::transform_storage(s.template childStorage<i>(), std::forward<Trafo>(t))),0)...});
-        return NodeTransformation::transform(s, std::forward<Trafo>(t), std::get<i>(storage)...);
-      }
+      typedef Impl::TransformNode<SourceTree,Transformation> NodeTransformation;
 
-      template<typename Trafo, std::size_t... i>
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, Trafo&& t, std::index_sequence<i...> indices)
-      {
-        std::tuple<typename ChildTransformation<i>::transformed_storage_type...> storage;
-        Dune::Hybrid::Impl::evaluateFoldExpression<int>({(setElement<i>(storage, ChildTransformation<i>::transform_storage(sp->template childStorage<i>(), std::forward<Trafo>(t))),0)...});
-        return NodeTransformation::transform_storage(sp, std::forward<Trafo>(t), std::get<i>(storage)...);
-      }
-    };
+      // the type of the new tree that will result from this transformation
+      typedef typename NodeTransformation::transformed_type transformed_type;
 
+      // the storage type of the new tree that will result from this transformation
+      typedef typename NodeTransformation::transformed_storage_type transformed_storage_type;
 
-    // the specialization of transformation<> for the CompositeNode. This just extracts the
-    // CompositeNode::ChildTypes member and forwards to the helper struct
-    template<typename S, typename T>
-    struct TransformTree<S,T,CompositeNodeTag,true>
-    {
+#endif // DOXYGEN
 
-    private:
+      //! The type of the transformed tree.
+      typedef transformed_type type;
 
-      typedef typename S::ChildTypes ChildTypes;
+      typedef type Type;
 
-      static auto child_indices()
+      //! Apply transformation to an existing tree s.
+      static transformed_type transform(const SourceTree& s, const Transformation& t = Transformation())
       {
-        return std::make_index_sequence<S::degree()>();
+        return NodeTransformation::transform(s,t);
       }
 
-    public:
-
-      typedef typename transform_composite_node<S,ChildTypes,T>::transformed_type transformed_type;
-      typedef typename transform_composite_node<S,ChildTypes,T>::transformed_storage_type transformed_storage_type;
+      //! Apply transformation to an existing tree s.
+      static transformed_type transform(const SourceTree& s, Transformation& t)
+      {
+        return NodeTransformation::transform(s,t);
+      }
 
-      static transformed_type transform(const S& s, T& t)
+      //! Apply transformation to an existing tree s.
+      static transformed_type transform(std::shared_ptr<const SourceTree> sp, const Transformation& t = Transformation())
       {
-        return transform_composite_node<S,ChildTypes,T>::transform(s,t,child_indices());
+        return NodeTransformation::transform(std::move(sp),t);
       }
 
-      static transformed_type transform(const S& s, const T& t)
+      //! Apply transformation to an existing tree s.
+      static transformed_type transform(std::shared_ptr<const SourceTree> sp, Transformation& t)
       {
-        return transform_composite_node<S,ChildTypes,T>::transform(s,t,child_indices());
+        return NodeTransformation::transform(std::move(sp),t);
       }
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, T& t)
+      //! Apply transformation to storage type of an existing tree, returning a heap-allocated storage type
+      //! instance of the transformed tree.
+      static transformed_storage_type transform_storage(std::shared_ptr<const SourceTree> sp, const Transformation& t = Transformation())
       {
-        return transform_composite_node<S,ChildTypes,T>::transform_storage(sp,t,child_indices());
+        return NodeTransformation::transform_storage(std::move(sp),t);
       }
 
-      static transformed_storage_type transform_storage(std::shared_ptr<const S> sp, const T& t)
+      //! Apply transformation to storage type of an existing tree, returning a heap-allocated storage type
+      //! instance of the transformed tree.
+      static transformed_storage_type transform_storage(std::shared_ptr<const SourceTree> sp, Transformation& t)
       {
-        return transform_composite_node<S,ChildTypes,T>::transform_storage(sp,t,child_indices());
+        return NodeTransformation::transform_storage(std::move(sp),t);
       }
 
-    };
 
-    // non-recursive version of the CompositeNode transformation.
-    template<typename S, typename T>
-    struct TransformTree<S,T,CompositeNodeTag,false>
-      : public TransformTreeNonRecursive<S,T>
-    {};
+    };
 
-#endif // DOXYGEN
 
     //! \} group Traversal
 
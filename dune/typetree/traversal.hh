@@ -6,6 +6,7 @@
 #ifndef DUNE_TYPETREE_TRAVERSAL_HH
 #define DUNE_TYPETREE_TRAVERSAL_HH
 
+#include <type_traits>
 #include <utility>
 
 #include <dune/common/hybridutilities.hh>
@@ -43,6 +44,20 @@ namespace Dune {
       ));
 
 
+      // Checks whether the children of Tree are traversed with run-time indices. This is the case
+      // for uniform nodes if the visitor prefers dynamic traversal, if the degree is not static,
+      // or if the degree exceeds the static degree threshold of the visitor.
+      template<class Visitor, class Tree>
+      constexpr bool dynamicChildIndices()
+      {
+        if constexpr (not Concept::UniformInnerTreeNode<Tree>)
+          return false;
+        else if constexpr (Visitor::treePathType == TreePathType::dynamic or not Concept::StaticDegreeInnerTreeNode<Tree>)
+          return true;
+        else
+          return Tree::degree() > Impl::staticDegreeThreshold<Visitor>();
+      }
+
       template<class Tree, TreePathType::Type pathType, class Prefix,
         std::enable_if_t<Tree::isLeaf, int> = 0>
       constexpr auto leafTreePathTuple(Prefix prefix)
@@ -75,6 +90,20 @@ namespace Dune {
         return Detail::leafTreePathTuple<Tree, pathType>(prefix, std::make_index_sequence<Tree::degree()>{});
       }
 
+      // Calls f for Tree and then recursively for the types of its children.
+      template<class Tree, class Prefix, class F>
+      constexpr void forEachNodeType(Prefix prefix, F& f)
+      {
+        f(std::type_identity<Tree>{}, prefix);
+        if constexpr (not Tree::isLeaf) {
+          static_assert(Concept::StaticDegreeInnerTreeNode<Tree>,
+            "forEachNodeType() requires all nodes of the tree to have a static degree");
+          Hybrid::forEach(Dune::range(index_constant<Tree::degree()>{}), [&](auto i) {
+            Detail::forEachNodeType<TypeTree::Child<Tree,i>>(Dune::TypeTree::push_back(prefix, i), f);
+          });
+        }
+      }
+
       /* The signature is the same as for the public applyToTree
        * function in Dune::Typetree, despite the additionally passed
        * treePath argument. The path passed here is associated to
@@ -88,7 +117,7 @@ namespace Dune {
        */
       template<class T, class TreePath, class V,
         std::enable_if_t<std::decay_t<T>::isLeaf, int> = 0>
-      void applyToTree(T&& tree, TreePath treePath, V&& visitor)
+      constexpr void applyToTree(T&& tree, TreePath treePath, V&& visitor)
       {
         visitor.leaf(tree, treePath);
       }
@@ -98,18 +127,18 @@ namespace Dune {
        */
       template<class T, class TreePath, class V,
         std::enable_if_t<not std::decay_t<T>::isLeaf, int> = 0>
-      void applyToTree(T&& tree, TreePath treePath, V&& visitor)
+      constexpr void applyToTree(T&& tree, TreePath treePath, V&& visitor)
       {
         using Tree = std::remove_reference_t<T>;
         using Visitor = std::remove_reference_t<V>;
         visitor.pre(tree, treePath);
 
-        // the visitor may specify preferred dynamic traversal
-        using preferDynamicTraversal = std::bool_constant<Visitor::treePathType == TreePathType::dynamic>;
+        // the visitor may specify preferred dynamic traversal or a static degree threshold
+        using preferDynamicTraversal = std::bool_constant<dynamicChildIndices<Visitor,Tree>()>;
 
         // create a dynamic or static index range
         auto indices = [&]{
-          if constexpr(preferDynamicTraversal::value && Concept::UniformInnerTreeNode<Tree>)
+          if constexpr(preferDynamicTraversal::value)
             return Dune::range(std::size_t(tree.degree()));
           else
             return Dune::range(tree.degree());
@@ -165,6 +194,36 @@ namespace Dune {
       return Detail::leafTreePathTuple<std::decay_t<Tree>, pathType>(hybridTreePath());
     }
 
+    //! Apply a function to the types of all nodes of a static tree.
+    /**
+     * \code
+     #include <dune/typetree/traversal.hh>
+     * \endcode
+     * This function traverses the types of the tree depth-first and calls `f(std::type_identity<Node>{}, treePath)`
+     * for every node, parents before their children. The tree path is a HybridTreePath of
+     * Dune::index_constant entries. No nodes are created, so the function can be used to build
+     * tables in constant expressions when no tree object is available, e.g.
+     * \code
+     * constexpr std::size_t leaves = [] {
+     *   std::size_t n = 0;
+     *   forEachNodeType<Tree>([&](auto node, auto treePath) { n += decltype(node)::type::isLeaf; });
+     *   return n;
+     * }();
+     * \endcode
+     *
+     * All nodes of the tree must have a static degree, i.e. the tree may not contain any
+     * DynamicPowerNode. Proxy and filtered nodes are traversed according to their own
+     * child types.
+     *
+     * \tparam Tree Type of tree to traverse
+     * \param f     The function called for every node type
+     */
+    template<class Tree, class F>
+    constexpr void forEachNodeType(F&& f)
+    {
+      Detail::forEachNodeType<std::decay_t<Tree>>(hybridTreePath(), f);
+    }
+
     //! Apply visitor to TypeTree.
     /**
      * \code
@@ -172,16 +231,19 @@ namespace Dune {
      * \endcode
      * This function applies the given visitor to the given tree. Both visitor and tree may be const
      * or non-const (if the compiler supports rvalue references, they may even be a non-const temporary).
+     * The traversal can be evaluated in constant expressions if the tree and the visitor support it,
+     * e.g. for trees built from LeafNode, ValuePowerNode and ValueCompositeNode.
      *
      * \note The visitor must implement the interface laid out by DefaultVisitor (most easily achieved by
      *       inheriting from it) and specify the required type of tree traversal (static or dynamic) by
-     *       inheriting from either StaticTraversal or DynamicTraversal.
+     *       inheriting from either StaticTraversal or DynamicTraversal. A static traversal can
+     *       be limited to power nodes of small degree by inheriting from StaticTraversalThreshold.
      *
      * \param tree    The tree the visitor will be applied to.
      * \param visitor The visitor to apply to the tree.
      */
     template<Concept::TreeNode Tree, typename Visitor>
-    void applyToTree(Tree&& tree, Visitor&& visitor)
+    constexpr void applyToTree(Tree&& tree, Visitor&& visitor)
     {
       Detail::applyToTree(tree, hybridTreePath(), visitor);
     }
@@ -0,0 +1,404 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_TRAVERSALPLAN_HH
+#define DUNE_TYPETREE_TRAVERSALPLAN_HH
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/visitor.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Tree Traversal
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    //! The visitor callbacks recorded in a TraversalPlan.
+    enum class TraversalCallback
+    {
+      pre, in, post, leaf, beforeChild, afterChild
+    };
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      template<typename T>
+      T traversalPlanIndex (std::size_t i)
+      {
+        if constexpr (IsIntegralConstant<T>::value)
+          return T();
+        else
+          return T(i);
+      }
+
+      template<typename TreePath>
+      struct TraversalPlanTreePath;
+
+      // Rebuilds a tree path from its recorded entries. Static entries are not read.
+      template<typename... T>
+      struct TraversalPlanTreePath<HybridTreePath<T...>>
+      {
+        static HybridTreePath<T...> get (const std::size_t* entries)
+        {
+          return unpackIntegerSequence([&](auto... k) {
+              return HybridTreePath<T...>(traversalPlanIndex<T>(entries[k])...);
+            }, std::index_sequence_for<T...>());
+        }
+
+        static void append (std::vector<std::size_t>& entries, const HybridTreePath<T...>& treePath)
+        {
+          unpackIntegerSequence([&](auto... k) {
+              (entries.push_back(std::size_t(treePath[k])),...);
+            }, std::index_sequence_for<T...>());
+        }
+      };
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    //! A recorded traversal of a tree that can be replayed without recursion.
+    /**
+     * \code
+     #include <dune/typetree/traversalplan.hh>
+     * \endcode
+     * A TraversalPlan records the sequence of visitor callbacks that applyToTree() issues for a
+     * given tree and visitor type, as a flat array of steps. Each step stores the callback, pointers
+     * to the node (and child) and the entries of the tree path. Callbacks that the visitor inherits
+     * unchanged from DefaultVisitor are not recorded, and consecutive steps with the same callback,
+     * node type and tree path type are replayed by a single indirect call. Replaying the plan calls
+     * the visitor in the same order with the same arguments as applyToTree(), but without
+     * recursion, degree queries and dereferencing the child storage of the nodes. This pays off if
+     * the same tree is traversed many times with a visitor that only implements a few callbacks,
+     * e.g. in the bind step of a local function space:
+     * \code
+     * TraversalPlan<Tree,BindVisitor> plan;
+     * for (const auto& element : elements(gridView))
+     *   plan.apply(tree,BindVisitor(element));
+     * \endcode
+     *
+     * The plan is recorded on the first call of apply() and recorded again automatically if it is
+     * applied to a different tree. Checking the structure of the tree would cost as much as the
+     * traversal itself, so apply() does not do it: after changing the structure of the recorded
+     * tree, e.g. by replacing a child with setChild() or by assigning to an inner node, call
+     * invalidate() or record(). The plan also stores the addresses of all visited children and the
+     * degrees of the nodes with a dynamic degree, which valid() compares with the tree. apply()
+     * asserts this check in debug builds, and changes of other trees do not affect the plan.
+     *
+     * \tparam Tree     The type of the tree, which may be const.
+     * \tparam Visitor  The type of the visitor. It must implement the interface of applyToTree().
+     */
+    template<typename Tree, typename Visitor>
+    class TraversalPlan
+    {
+
+    public:
+
+      //! A single visitor callback of the plan.
+      struct Step
+      {
+        //! The callback of the visitor.
+        TraversalCallback callback;
+        //! The node passed to the callback.
+        const void* node;
+        //! The child passed to beforeChild() and afterChild().
+        const void* child;
+        //! The child index passed to beforeChild() and afterChild().
+        std::size_t childIndex;
+        //! The offset of the tree path entries in the entry array of the plan.
+        std::size_t treePathOffset;
+        //! Calls the visitor with the arguments of the steps in [first,last), which all share this function.
+        void (*call)(Visitor& visitor, const Step* first, const Step* last, const std::size_t* treePathEntries);
+      };
+
+      //! A part of the structure of the tree that the plan depends on.
+      struct StructureCheck
+      {
+        //! The inner node whose structure is checked.
+        const void* node;
+        //! The recorded child, or nullptr if the degree of the node is checked.
+        const void* child;
+        //! The index of the child, or the recorded degree of the node.
+        std::size_t index;
+        //! Checks whether the node still has this child or degree.
+        bool (*check)(const StructureCheck& check);
+      };
+
+      //! Creates an empty plan, which is recorded on the first call of apply().
+      TraversalPlan () = default;
+
+      //! Records the plan for tree.
+      explicit TraversalPlan (Tree& tree)
+      {
+        record(tree);
+      }
+
+      //! Records the traversal of tree, replacing the current plan.
+      void record (Tree& tree)
+      {
+        _steps.clear();
+        _treePathEntries.clear();
+        _structure.clear();
+        _runs.clear();
+        Recorder recorder{this};
+        Detail::applyToTree(tree,hybridTreePath(),recorder);
+        for (std::size_t i = 0; i < _steps.size(); ++i)
+          if (i == 0 or _steps[i].call != _steps[i-1].call)
+            _runs.push_back(i);
+        _runs.push_back(_steps.size());
+        _tree = &tree;
+      }
+
+      //! Discards the recorded plan, so that the next call of apply() records it again.
+      void invalidate ()
+      {
+        _tree = nullptr;
+      }
+
+      //! Checks whether the plan has been recorded for tree and the structure has not changed since.
+      /**
+       * The checks are evaluated in the order of the traversal, so the degree of a node is checked
+       * before its children are accessed. This visits all recorded nodes and is thus about as
+       * expensive as a traversal of the tree.
+       */
+      bool valid (const Tree& tree) const
+      {
+        if (_tree != &tree)
+          return false;
+        for (const StructureCheck& check : _structure)
+          if (not check.check(check))
+            return false;
+        return true;
+      }
+
+      //! Applies visitor to tree by replaying the plan, recording it first for a different tree.
+      /**
+       * \note The structure of tree is only checked in debug builds, call invalidate() after
+       *       changing it.
+       */
+      void apply (Tree& tree, Visitor& visitor)
+      {
+        if (_tree != &tree)
+          record(tree);
+        assert(valid(tree) && "TraversalPlan: the structure of the tree has changed, call invalidate()");
+        const Step* steps = _steps.data();
+        for (std::size_t r = 0; r + 1 < _runs.size(); ++r)
+          steps[_runs[r]].call(visitor,steps + _runs[r],steps + _runs[r+1],_treePathEntries.data());
+      }
+
+      //! Applies a temporary visitor to tree by replaying the plan.
+      void apply (Tree& tree, Visitor&& visitor)
+      {
+        apply(tree,visitor);
+      }
+
+      //! The recorded steps in the order of the callbacks.
+      const std::vector<Step>& steps () const
+      {
+        return _steps;
+      }
+
+    private:
+
+      template<typename Node>
+      static Node& node (const void* p)
+      {
+        return *static_cast<Node*>(const_cast<void*>(p));
+      }
+
+      template<typename TreePath>
+      static TreePath treePath (const std::size_t* entries)
+      {
+        return Impl::TraversalPlanTreePath<TreePath>::get(entries);
+      }
+
+      template<TraversalCallback callback, typename Node, typename TreePath>
+      static void callNode (Visitor& visitor, const Step* first, const Step* last, const std::size_t* entries)
+      {
+        for (const Step* step = first; step != last; ++step)
+        {
+          Node& n = node<Node>(step->node);
+          TreePath tp = treePath<TreePath>(entries + step->treePathOffset);
+          if constexpr (callback == TraversalCallback::pre)
+            visitor.pre(n,tp);
+          else if constexpr (callback == TraversalCallback::in)
+            visitor.in(n,tp);
+          else if constexpr (callback == TraversalCallback::post)
+            visitor.post(n,tp);
+          else
+            visitor.leaf(n,tp);
+        }
+      }
+
+      template<typename Node>
+      static bool checkDegree (const StructureCheck& check)
+      {
+        return static_cast<const Node*>(check.node)->degree() == check.index;
+      }
+
+      template<typename Node, typename ChildIndex>
+      static bool checkChild (const StructureCheck& check)
+      {
+        auto i = Impl::traversalPlanIndex<ChildIndex>(check.index);
+        return &static_cast<const Node*>(check.node)->child(i) == check.child;
+      }
+
+      template<TraversalCallback callback, typename Node, typename Child, typename TreePath, typename ChildIndex>
+      static void callChild (Visitor& visitor, const Step* first, const Step* last, const std::size_t* entries)
+      {
+        for (const Step* step = first; step != last; ++step)
+        {
+          Node& n = node<Node>(step->node);
+          Child& c = node<Child>(step->child);
+          TreePath tp = treePath<TreePath>(entries + step->treePathOffset);
+          auto i = Impl::traversalPlanIndex<ChildIndex>(step->childIndex);
+          if constexpr (callback == TraversalCallback::beforeChild)
+            visitor.beforeChild(n,c,tp,i);
+          else
+            visitor.afterChild(n,c,tp,i);
+        }
+      }
+
+      // Visitor that records the callbacks of applyToTree() with the traversal properties of Visitor.
+      struct Recorder
+      {
+        static const TreePathType::Type treePathType = Visitor::treePathType;
+
+        static const std::size_t staticDegreeThreshold = Impl::staticDegreeThreshold<Visitor>();
+
+        template<typename... T>
+        struct VisitChild
+          : public Visitor::template VisitChild<T...>
+        {};
+
+        // The callbacks that Visitor inherits unchanged from DefaultVisitor are no-ops and are not
+        // recorded. If Visitor implements or overloads a callback itself, taking its address yields
+        // another type or fails, and the callback is recorded.
+        template<typename T, typename TreePath>
+        static constexpr bool recordsPre = not requires {
+          requires std::is_same_v<decltype(&Visitor::template pre<T,TreePath>),decltype(&DefaultVisitor::template pre<T,TreePath>)>;
+        };
+
+        template<typename T, typename TreePath>
+        static constexpr bool recordsIn = not requires {
+          requires std::is_same_v<decltype(&Visitor::template in<T,TreePath>),decltype(&DefaultVisitor::template in<T,TreePath>)>;
+        };
+
+        template<typename T, typename TreePath>
+        static constexpr bool recordsPost = not requires {
+          requires std::is_same_v<decltype(&Visitor::template post<T,TreePath>),decltype(&DefaultVisitor::template post<T,TreePath>)>;
+        };
+
+        template<typename T, typename TreePath>
+        static constexpr bool recordsLeaf = not requires {
+          requires std::is_same_v<decltype(&Visitor::template leaf<T,TreePath>),decltype(&DefaultVisitor::template leaf<T,TreePath>)>;
+        };
+
+        template<typename T, typename Child, typename TreePath, typename ChildIndex>
+        static constexpr bool recordsBeforeChild = not requires {
+          requires std::is_same_v<decltype(&Visitor::template beforeChild<T,Child,TreePath,ChildIndex>),decltype(&DefaultVisitor::template beforeChild<T,Child,TreePath,ChildIndex>)>;
+        };
+
+        template<typename T, typename Child, typename TreePath, typename ChildIndex>
+        static constexpr bool recordsAfterChild = not requires {
+          requires std::is_same_v<decltype(&Visitor::template afterChild<T,Child,TreePath,ChildIndex>),decltype(&DefaultVisitor::template afterChild<T,Child,TreePath,ChildIndex>)>;
+        };
+
+        template<TraversalCallback callback, typename T, typename TreePath>
+        void addNode (T& t, TreePath tp)
+        {
+          plan->_steps.push_back({callback,&t,nullptr,0,plan->_treePathEntries.size(),
+                                  &TraversalPlan::template callNode<callback,T,TreePath>});
+          Impl::TraversalPlanTreePath<TreePath>::append(plan->_treePathEntries,tp);
+        }
+
+        template<TraversalCallback callback, typename T, typename Child, typename TreePath, typename ChildIndex>
+        void addChild (T& t, Child& child, TreePath tp, ChildIndex i)
+        {
+          plan->_steps.push_back({callback,&t,&child,std::size_t(i),plan->_treePathEntries.size(),
+                                  &TraversalPlan::template callChild<callback,T,Child,TreePath,ChildIndex>});
+          Impl::TraversalPlanTreePath<TreePath>::append(plan->_treePathEntries,tp);
+        }
+
+        template<typename T, typename TreePath>
+        void pre (T&& t, TreePath tp)
+        {
+          using Node = std::remove_reference_t<T>;
+          if constexpr (not IsIntegralConstant<decltype(t.degree())>::value)
+            plan->_structure.push_back({&t,nullptr,std::size_t(t.degree()),
+                                        &TraversalPlan::template checkDegree<Node>});
+          if constexpr (recordsPre<T,TreePath>)
+            addNode<TraversalCallback::pre>(t,tp);
+        }
+
+        template<typename T, typename TreePath>
+        void in (T&& t, TreePath tp)
+        {
+          if constexpr (recordsIn<T,TreePath>)
+            addNode<TraversalCallback::in>(t,tp);
+        }
+
+        template<typename T, typename TreePath>
+        void post (T&& t, TreePath tp)
+        {
+          if constexpr (recordsPost<T,TreePath>)
+            addNode<TraversalCallback::post>(t,tp);
+        }
+
+        template<typename T, typename TreePath>
+        void leaf (T&& t, TreePath tp)
+        {
+          if constexpr (recordsLeaf<T,TreePath>)
+            addNode<TraversalCallback::leaf>(t,tp);
+        }
+
+        template<typename T, typename Child, typename TreePath, typename ChildIndex>
+        void beforeChild (T&& t, Child&& child, TreePath tp, ChildIndex i)
+        {
+          using Node = std::remove_reference_t<T>;
+          plan->_structure.push_back({&t,&child,std::size_t(i),
+                                      &TraversalPlan::template checkChild<Node,ChildIndex>});
+          if constexpr (recordsBeforeChild<T,Child,TreePath,ChildIndex>)
+            addChild<TraversalCallback::beforeChild>(t,child,tp,i);
+        }
+
+        template<typename T, typename Child, typename TreePath, typename ChildIndex>
+        void afterChild (T&& t, Child&& child, TreePath tp, ChildIndex i)
+        {
+          if constexpr (recordsAfterChild<T,Child,TreePath,ChildIndex>)
+            addChild<TraversalCallback::afterChild>(t,child,tp,i);
+        }
+
+        TraversalPlan* plan;
+      };
+
+      std::vector<Step> _steps;
+      std::vector<std::size_t> _treePathEntries;
+      std::vector<StructureCheck> _structure;
+      // the first step of each run of steps with the same call, followed by the number of steps
+      std::vector<std::size_t> _runs;
+      const Tree* _tree = nullptr;
+
+    };
+
+    //! \} group Tree Traversal
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_TRAVERSALPLAN_HH
@@ -0,0 +1,774 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_UNIQUENODES_HH
+#define DUNE_TYPETREE_UNIQUENODES_HH
+
+#include <cassert>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/childextraction.hh>
+#include <dune/typetree/typetraits.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+#ifndef DOXYGEN
+
+    namespace Impl {
+
+      // Deep copy of a uniquely owned child.
+      template<typename T>
+      std::unique_ptr<T> cloneUniqueChild (const std::unique_ptr<T>& t)
+      {
+        return t ? std::make_unique<T>(*t) : std::unique_ptr<T>();
+      }
+
+      // Takes ownership of a child passed by value.
+      template<typename T, typename Child>
+      std::unique_ptr<T> makeUniqueChild (Child&& child)
+      {
+        return std::make_unique<T>(std::forward<Child>(child));
+      }
+
+    } // namespace Impl
+
+#endif // DOXYGEN
+
+    /** \brief Collect k instances of type T within a \ref TypeTree, with each child uniquely owned by the node.
+     *
+     * UniquePowerNode is a variant of PowerNode that stores its children in a `std::unique_ptr`
+     * instead of a `std::shared_ptr`. The resulting trees are strictly hierarchical and do not
+     * need any reference counting. As a consequence, children cannot be shared between nodes:
+     * Copying a node copies the complete subtree and children passed in as lvalues are copied.
+     *
+     * The node does not provide childStorage(), as a `std::shared_ptr` to a child could outlive the
+     * node. Use childStorageRef() to access the owning `std::unique_ptr`. Tree transformations
+     * transform the children by reference, so a transformed tree must not outlive the source tree
+     * if its nodes refer to the source nodes.
+     *
+     *  \tparam T The base type
+     *  \tparam k The number of instances this node should collect
+     */
+    template<typename T, std::size_t k>
+    class UniquePowerNode
+    {
+
+    public:
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a power in the \ref TypeTree.
+      static const bool isPower = true;
+
+      //! Mark this class as a non composite in the \ref TypeTree.
+      static const bool isComposite = false;
+
+      static constexpr auto degree ()
+      {
+        return std::integral_constant<std::size_t,k>{};
+      }
+
+      //! The type tag that describes a PowerNode.
+      typedef PowerNodeTag NodeTag;
+
+      //! The type of each child.
+      typedef T ChildType;
+
+      //! The type used for storing the children.
+      typedef std::array<std::unique_ptr<T>,k> NodeStorage;
+
+
+      //! Access to the type and storage type of the i-th child.
+      template<std::size_t i>
+      struct Child
+      {
+
+        static_assert((i < degree()), "child index out of range");
+
+        //! The type of the child.
+        typedef T Type;
+
+        //! The type of the child.
+        typedef T type;
+      };
+
+      //! @name Child Access (templated methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      template<std::size_t i>
+      T& child (index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      template<std::size_t i>
+      const T& child (index_constant<i> = {}) const
+      {
+        static_assert((i < degree()), "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * As the unique_ptr grants mutable access to the child, this method is
+       * not available for const nodes.
+       * \returns a const reference to the unique_ptr owning the i-th child.
+       */
+      template<std::size_t i>
+      const std::unique_ptr<T>& childStorageRef (index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        return _children[i];
+      }
+
+      //! Store the passed value in i-th child.
+      template<std::size_t i>
+      void setChild (T&& t, index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        _children[i] = std::make_unique<T>(std::move(t));
+      }
+
+      //! Sets the stored value representing the i-th child to the passed-in value.
+      template<std::size_t i>
+      void setChild (std::unique_ptr<T> st, index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        _children[i] = std::move(st);
+      }
+
+      //! Releases the ownership of the i-th child and returns it.
+      template<std::size_t i>
+      std::unique_ptr<T> releaseChild (index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        return std::move(_children[i]);
+      }
+
+      //! @}
+
+
+      //! @name Child Access (Dynamic methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      T& child (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      const T& child (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * As the unique_ptr grants mutable access to the child, this method is
+       * not available for const nodes.
+       * \returns a const reference to the unique_ptr owning the i-th child.
+       */
+      const std::unique_ptr<T>& childStorageRef (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Store the passed value in i-th child.
+      void setChild (std::size_t i, T&& t)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::make_unique<T>(std::move(t));
+      }
+
+      //! Sets the stored value representing the i-th child to the passed-in value.
+      void setChild (std::size_t i, std::unique_ptr<T> st)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::move(st);
+      }
+
+      //! Releases the ownership of the i-th child and returns it.
+      std::unique_ptr<T> releaseChild (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return std::move(_children[i]);
+      }
+
+      const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Nested Child Access
+      //! @{
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i)
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      const ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i) const
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! @}
+
+      //! @name Copying
+      //! @{
+
+      //! Copies the node together with all of its children.
+      UniquePowerNode (const UniquePowerNode& other)
+      {
+        for (std::size_t i = 0; i < k; ++i)
+          _children[i] = Impl::cloneUniqueChild(other._children[i]);
+      }
+
+      UniquePowerNode (UniquePowerNode&&) = default;
+
+      //! Copies all children of other.
+      UniquePowerNode& operator= (const UniquePowerNode& other)
+      {
+        for (std::size_t i = 0; i < k; ++i)
+          _children[i] = Impl::cloneUniqueChild(other._children[i]);
+        return *this;
+      }
+
+      UniquePowerNode& operator= (UniquePowerNode&&) = default;
+
+      //! @}
+
+      //! @name Constructors
+      //! @{
+
+    protected:
+
+      //! Default constructor.
+      /**
+       * \warning When using the default constructor, make sure to set ALL children
+       * by means of the setChild() methods!
+       */
+      UniquePowerNode ()
+      {}
+
+      //! Initialize the UniquePowerNode by taking over the passed-in storage.
+      explicit UniquePowerNode (NodeStorage&& children)
+        : _children(std::move(children))
+      {}
+
+#ifdef DOXYGEN
+
+      //! Initialize all children with copies of or by moving the passed-in objects.
+      UniquePowerNode(T&& t1, T&& t2, ...)
+      {}
+
+#else
+
+      template<typename... Children,
+        std::enable_if_t<
+          std::conjunction<std::is_same<ChildType, std::decay_t<Children>>...>::value
+          ,int> = 0>
+      UniquePowerNode (Children&&... children)
+      {
+        static_assert(degree() == sizeof...(Children), "UniquePowerNode constructor is called with incorrect number of children");
+        _children = NodeStorage{Impl::makeUniqueChild<T>(std::forward<Children>(children))...};
+      }
+
+      template<typename... Children,
+        std::enable_if_t<
+          std::conjunction<std::is_same<ChildType, Children>...>::value
+          ,int> = 0>
+      UniquePowerNode (std::unique_ptr<Children>... children)
+      {
+        static_assert(degree() == sizeof...(Children), "UniquePowerNode constructor is called with incorrect number of children");
+        _children = NodeStorage{std::move(children)...};
+      }
+
+#endif // DOXYGEN
+
+      //! @}
+
+    private:
+      NodeStorage _children;
+    };
+
+
+    /** \brief Collect multiple instances of type T within a \ref TypeTree, with each child uniquely owned by the node.
+     *
+     * UniqueDynamicPowerNode is a variant of DynamicPowerNode that stores its children in a
+     * `std::unique_ptr`. See UniquePowerNode for details on the ownership semantics.
+     *
+     *  \tparam T  Type of the tree-node children
+     */
+    template<typename T>
+    class UniqueDynamicPowerNode
+    {
+
+    public:
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a power in the \ref TypeTree.
+      static const bool isPower = true;
+
+      //! Mark this class as a non composite in the \ref TypeTree.
+      static const bool isComposite = false;
+
+      //! The number of children.
+      std::size_t degree() const
+      {
+        return _children.size();
+      }
+
+      //! The type tag that describes the node.
+      typedef DynamicPowerNodeTag NodeTag;
+
+      //! The type of each child.
+      typedef T ChildType;
+
+      //! The storage type of each child.
+      typedef std::unique_ptr<T> ChildStorageType;
+
+      //! The type used for storing the children.
+      typedef std::vector<ChildStorageType> NodeStorage;
+
+
+      //! @name Child Access (Dynamic methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      ChildType& child (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      const ChildType& child (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return *_children[i];
+      }
+
+      //! Returns a reference to the storage of the i-th child.
+      /**
+       * As the unique_ptr grants mutable access to the child, this method is
+       * not available for const nodes.
+       * \returns a const reference to the unique_ptr owning the i-th child.
+       */
+      const ChildStorageType& childStorageRef (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Store the passed value in i-th child.
+      void setChild (std::size_t i, ChildType&& t)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::make_unique<T>(std::move(t));
+      }
+
+      //! Sets the stored value representing the i-th child to the passed-in value.
+      void setChild (std::size_t i, ChildStorageType st)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::move(st);
+      }
+
+      //! Releases the ownership of the i-th child and returns it.
+      ChildStorageType releaseChild (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return std::move(_children[i]);
+      }
+
+      const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Copying
+      //! @{
+
+      //! Copies the node together with all of its children.
+      UniqueDynamicPowerNode (const UniqueDynamicPowerNode& other)
+      {
+        _children.reserve(other._children.size());
+        for (const auto& c : other._children)
+          _children.push_back(Impl::cloneUniqueChild(c));
+      }
+
+      UniqueDynamicPowerNode (UniqueDynamicPowerNode&&) = default;
+
+      //! Copies all children of other.
+      UniqueDynamicPowerNode& operator= (const UniqueDynamicPowerNode& other)
+      {
+        NodeStorage children;
+        children.reserve(other._children.size());
+        for (const auto& c : other._children)
+          children.push_back(Impl::cloneUniqueChild(c));
+        _children = std::move(children);
+        return *this;
+      }
+
+      UniqueDynamicPowerNode& operator= (UniqueDynamicPowerNode&&) = default;
+
+      //! @}
+
+      //! @name Constructors
+      //! @{
+
+    protected:
+
+      //! The Default constructor is deleted, since you need to pass the number of children.
+      UniqueDynamicPowerNode () = delete;
+
+      //! Construct a node with the given number of children.
+      /**
+       * \warning When using this constructor, make sure to set ALL children
+       * by means of the setChild() methods!
+       */
+      explicit UniqueDynamicPowerNode (std::size_t size)
+        : _children(size)
+      {}
+
+      //! Initialize the UniqueDynamicPowerNode by taking over the passed-in storage.
+      explicit UniqueDynamicPowerNode (NodeStorage children)
+        : _children(std::move(children))
+      {}
+
+#ifdef DOXYGEN
+
+      //! Initialize all children with copies of or by moving the passed-in objects.
+      UniqueDynamicPowerNode (T&& t1, T&& t2, ...)
+      {}
+
+#else
+
+      template<typename... Children,
+        std::enable_if_t<(std::is_same_v<ChildType, std::decay_t<Children>> &&...), bool> = true>
+      UniqueDynamicPowerNode (Children&&... children)
+      {
+        _children.reserve(sizeof...(Children));
+        (_children.push_back(Impl::makeUniqueChild<T>(std::forward<Children>(children))), ...);
+      }
+
+      template<typename... Children,
+        std::enable_if_t<(std::is_same_v<ChildType, Children> &&...), bool> = true>
+      UniqueDynamicPowerNode (std::unique_ptr<Children>... children)
+      {
+        _children.reserve(sizeof...(Children));
+        (_children.push_back(std::move(children)), ...);
+      }
+
+#endif // DOXYGEN
+
+      //! @}
+
+    private:
+      NodeStorage _children;
+    };
+
+
+    /** \brief Base class for composite nodes whose children are uniquely owned by the node.
+     *
+     * UniqueCompositeNode is a variant of CompositeNode that stores its children in a
+     * `std::unique_ptr`. See UniquePowerNode for details on the ownership semantics.
+     */
+    template<typename... Children>
+    class UniqueCompositeNode
+    {
+
+    public:
+
+      //! The type tag that describes a CompositeNode.
+      typedef CompositeNodeTag NodeTag;
+
+      //! The type used for storing the children.
+      typedef std::tuple<std::unique_ptr<Children>... > NodeStorage;
+
+      //! A tuple storing the types of all children.
+      typedef std::tuple<Children...> ChildTypes;
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a non power in the \ref TypeTree.
+      static const bool isPower = false;
+
+      //! Mark this class as a composite in the \ref TypeTree.
+      static const bool isComposite = true;
+
+      static constexpr auto degree ()
+      {
+        return std::integral_constant<std::size_t,sizeof...(Children)>{};
+      }
+
+      //! Access to the type and storage type of the i-th child.
+      template<std::size_t k>
+      struct Child {
+
+        static_assert((k < degree()), "child index out of range");
+
+        //! The type of the child.
+        typedef typename std::tuple_element<k,ChildTypes>::type Type;
+
+        //! The type of the child.
+        typedef typename std::tuple_element<k,ChildTypes>::type type;
+      };
+
+      //! @name Child Access
+      //! @{
+
+      //! Returns the k-th child.
+      /**
+       * \returns a reference to the k-th child.
+       */
+      template<std::size_t k>
+      typename Child<k>::Type& child (index_constant<k> = {})
+      {
+        return *std::get<k>(_children);
+      }
+
+      //! Returns the k-th child (const version).
+      /**
+       * \returns a const reference to the k-th child.
+       */
+      template<std::size_t k>
+      const typename Child<k>::Type& child (index_constant<k> = {}) const
+      {
+        return *std::get<k>(_children);
+      }
+
+      //! Returns a reference to the storage of the k-th child.
+      /**
+       * As the unique_ptr grants mutable access to the child, this method is
+       * not available for const nodes.
+       * \returns a const reference to the unique_ptr owning the k-th child.
+       */
+      template<std::size_t k>
+      const std::unique_ptr<typename Child<k>::Type>& childStorageRef (index_constant<k> = {})
+      {
+        return std::get<k>(_children);
+      }
+
+      //! Store the passed value in k-th child.
+      template<std::size_t k>
+      void setChild (typename Child<k>::Type&& child, index_constant<k> = {})
+      {
+        std::get<k>(_children) = std::make_unique<typename Child<k>::Type>(std::move(child));
+      }
+
+      //! Sets the storage of the k-th child to the passed-in value.
+      template<std::size_t k>
+      void setChild (std::unique_ptr<typename Child<k>::Type> child, index_constant<k> = {})
+      {
+        std::get<k>(_children) = std::move(child);
+      }
+
+      //! Releases the ownership of the k-th child and returns it.
+      template<std::size_t k>
+      std::unique_ptr<typename Child<k>::Type> releaseChild (index_constant<k> = {})
+      {
+        return std::move(std::get<k>(_children));
+      }
+
+      const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Nested Child Access
+      //! @{
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i)
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      const ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i) const
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! @}
+
+      //! @name Copying
+      //! @{
+
+      //! Copies the node together with all of its children.
+      UniqueCompositeNode (const UniqueCompositeNode& other)
+        : _children(std::apply([](const auto&... c) {
+              return NodeStorage(Impl::cloneUniqueChild(c)...);
+            }, other._children))
+      {}
+
+      UniqueCompositeNode (UniqueCompositeNode&&) = default;
+
+      //! Copies all children of other.
+      UniqueCompositeNode& operator= (const UniqueCompositeNode& other)
+      {
+        _children = std::apply([](const auto&... c) {
+            return NodeStorage(Impl::cloneUniqueChild(c)...);
+          }, other._children);
+        return *this;
+      }
+
+      UniqueCompositeNode& operator= (UniqueCompositeNode&&) = default;
+
+      //! @}
+
+    protected:
+
+      //! @name Constructors
+      //! @{
+
+      //! Default constructor.
+      /**
+       * \warning The resulting object will not be usable before its children are set
+       * using any of the setChild(...) methods!
+       */
+      UniqueCompositeNode ()
+      {}
+
+      //! Initialize all children with copies of or by moving the passed-in objects.
+      template<typename... Args,
+        std::enable_if_t<(sizeof...(Args) == sizeof...(Children)) &&
+                         (std::is_same_v<Children,std::decay_t<Args>> && ...), int> = 0>
+      UniqueCompositeNode (Args&&... args)
+        : _children(Impl::makeUniqueChild<Children>(std::forward<Args>(args))...)
+      {}
+
+      //! Initialize the UniqueCompositeNode by taking over the passed-in storage objects.
+      UniqueCompositeNode (std::unique_ptr<Children>... children)
+        : _children(std::move(children)...)
+      {}
+
+      //! Initialize the UniqueCompositeNode by taking over the passed-in storage.
+      UniqueCompositeNode (NodeStorage&& children)
+        : _children(std::move(children))
+      {}
+
+      //! @}
+
+    private:
+      NodeStorage _children;
+    };
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_UNIQUENODES_HH
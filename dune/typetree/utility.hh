@@ -61,12 +61,15 @@ namespace Dune {
        * @brief Applies left fold to a binary operator
        * @details End of recursion of the fold operator
        *
+       * The result is returned by value, as it is usually a temporary created by the
+       * previous evaluation of the binary operator.
+       *
        * @param binary_op  Binary functor (discarded)
        * @param arg        Final result of the fold expansion
-       * @return constexpr decltype(auto)  Final result of the fold expansion
+       * @return constexpr auto  Final result of the fold expansion
        */
       template<class BinaryOp, class Arg>
-      constexpr decltype(auto)
+      constexpr auto
       left_fold(const BinaryOp& binary_op, Arg&& arg)
       {
         return std::forward<Arg>(arg);
@@ -112,6 +115,9 @@ namespace Dune {
     /**
      * This struct extracts basic information about the passed TypeTree and
      * presents them in a static way suitable for use as compile-time constants.
+     * Trees may contain dynamic power nodes with a bounded degree, like
+     * BoundedDynamicPowerNode. In that case, nodeCount and leafCount are upper
+     * bounds computed from the maximum degree of these nodes.
      *
      * \tparam Tree  The TypeTree to examine.
      * \tparam Tag   Internal parameter, leave at default value.
@@ -175,6 +181,23 @@ namespace Dune {
     };
 
 
+    // dynamic power node with a bounded degree - the counts are upper bounds
+    template<typename Node>
+      requires requires { MaxDegree<Node>::value; }
+    struct TreeInfo<Node,DynamicPowerNodeTag>
+    {
+
+      typedef TreeInfo<typename Node::ChildType,NodeTag<typename Node::ChildType>> ChildInfo;
+
+      static const std::size_t depth = 1 + ChildInfo::depth;
+
+      static const std::size_t nodeCount = 1 + MaxDegree<Node>::value * ChildInfo::nodeCount;
+
+      static const std::size_t leafCount = MaxDegree<Node>::value * ChildInfo::leafCount;
+
+    };
+
+
     namespace {
 
       // TMP for iterating over the children of a composite node
@@ -0,0 +1,414 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+#ifndef DUNE_TYPETREE_VALUENODES_HH
+#define DUNE_TYPETREE_VALUENODES_HH
+
+#include <cassert>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/childextraction.hh>
+#include <dune/typetree/typetraits.hh>
+
+namespace Dune {
+  namespace TypeTree {
+
+    /** \addtogroup Nodes
+     *  \ingroup TypeTree
+     *  \{
+     */
+
+    /** \brief Collect k instances of type T within a \ref TypeTree, with the children stored by value.
+     *
+     * ValuePowerNode is a variant of PowerNode that stores its children directly in a `std::array`
+     * instead of behind a `std::shared_ptr`. As it does not allocate, a tree built from LeafNode,
+     * ValuePowerNode and ValueCompositeNode is a literal type if its leaves are, and it can be
+     * created and traversed with applyToTree() or Experimental::hybridApplyToTree() in constant
+     * expressions. This allows computing tables for static trees at compile time.
+     *
+     * Copying a node copies the complete subtree, and children cannot be shared between nodes.
+     * The node does not provide childStorage(), as a `std::shared_ptr` to a child could outlive the
+     * node. Tree transformations transform the children by reference, so a transformed tree must
+     * not outlive the source tree if its nodes refer to the source nodes.
+     *
+     *  \tparam T The base type
+     *  \tparam k The number of instances this node should collect
+     */
+    template<typename T, std::size_t k>
+    class ValuePowerNode
+    {
+
+    public:
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a power in the \ref TypeTree.
+      static const bool isPower = true;
+
+      //! Mark this class as a non composite in the \ref TypeTree.
+      static const bool isComposite = false;
+
+      static constexpr auto degree ()
+      {
+        return std::integral_constant<std::size_t,k>{};
+      }
+
+      //! The type tag that describes a PowerNode.
+      typedef PowerNodeTag NodeTag;
+
+      //! The type of each child.
+      typedef T ChildType;
+
+      //! The type used for storing the children.
+      typedef std::array<T,k> NodeStorage;
+
+
+      //! Access to the type and storage type of the i-th child.
+      template<std::size_t i>
+      struct Child
+      {
+
+        static_assert((i < degree()), "child index out of range");
+
+        //! The type of the child.
+        typedef T Type;
+
+        //! The type of the child.
+        typedef T type;
+      };
+
+      //! @name Child Access (templated methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      template<std::size_t i>
+      constexpr T& child (index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        return _children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      template<std::size_t i>
+      constexpr const T& child (index_constant<i> = {}) const
+      {
+        static_assert((i < degree()), "child index out of range");
+        return _children[i];
+      }
+
+      //! Store the passed value in i-th child.
+      template<std::size_t i>
+      constexpr void setChild (T t, index_constant<i> = {})
+      {
+        static_assert((i < degree()), "child index out of range");
+        _children[i] = std::move(t);
+      }
+
+      //! @}
+
+
+      //! @name Child Access (Dynamic methods)
+      //! @{
+
+      //! Returns the i-th child.
+      /**
+       * \returns a reference to the i-th child.
+       */
+      constexpr T& child (std::size_t i)
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Returns the i-th child (const version).
+      /**
+       * \returns a const reference to the i-th child.
+       */
+      constexpr const T& child (std::size_t i) const
+      {
+        assert(i < degree() && "child index out of range");
+        return _children[i];
+      }
+
+      //! Store the passed value in i-th child.
+      constexpr void setChild (std::size_t i, T t)
+      {
+        assert(i < degree() && "child index out of range");
+        _children[i] = std::move(t);
+      }
+
+      constexpr const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Nested Child Access
+      //! @{
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i)
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      const ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i) const
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! @}
+
+    protected:
+
+      //! @name Constructors
+      //! @{
+
+      //! Default constructor, which value-initializes all children.
+      constexpr ValuePowerNode ()
+        : _children{}
+      {}
+
+      //! Initialize the ValuePowerNode by taking over the passed-in storage.
+      explicit constexpr ValuePowerNode (NodeStorage children)
+        : _children(std::move(children))
+      {}
+
+#ifdef DOXYGEN
+
+      //! Initialize all children with copies of or by moving the passed-in objects.
+      ValuePowerNode(T&& t1, T&& t2, ...)
+      {}
+
+#else
+
+      template<typename... Children,
+        std::enable_if_t<
+          std::conjunction<std::is_same<ChildType, std::decay_t<Children>>...>::value
+          ,int> = 0>
+      constexpr ValuePowerNode (Children&&... children)
+        : _children{{std::forward<Children>(children)...}}
+      {
+        static_assert(degree() == sizeof...(Children), "ValuePowerNode constructor is called with incorrect number of children");
+      }
+
+#endif // DOXYGEN
+
+      //! @}
+
+    private:
+      NodeStorage _children;
+    };
+
+
+    //! Base class for composite nodes with the children stored by value.
+    /**
+     * ValueCompositeNode is a variant of CompositeNode that stores its children directly in a
+     * `std::tuple`. Like ValuePowerNode, it does not allocate and can be used in constant
+     * expressions, and it does not provide childStorage().
+     *
+     * \tparam Children The types of the children
+     */
+    template<typename... Children>
+    class ValueCompositeNode
+    {
+
+    public:
+
+      //! The type tag that describes a CompositeNode.
+      typedef CompositeNodeTag NodeTag;
+
+      //! The type used for storing the children.
+      typedef std::tuple<Children...> NodeStorage;
+
+      //! A tuple storing the types of all children.
+      typedef std::tuple<Children...> ChildTypes;
+
+      //! Mark this class as non leaf in the \ref TypeTree.
+      static const bool isLeaf = false;
+
+      //! Mark this class as a non power in the \ref TypeTree.
+      static const bool isPower = false;
+
+      //! Mark this class as a composite in the \ref TypeTree.
+      static const bool isComposite = true;
+
+      static constexpr auto degree ()
+      {
+        return std::integral_constant<std::size_t,sizeof...(Children)>{};
+      }
+
+      //! Access to the type and storage type of the i-th child.
+      template<std::size_t k>
+      struct Child {
+
+        static_assert((k < degree()), "child index out of range");
+
+        //! The type of the child.
+        typedef typename std::tuple_element<k,ChildTypes>::type Type;
+
+        //! The type of the child.
+        typedef typename std::tuple_element<k,ChildTypes>::type type;
+      };
+
+      //! @name Child Access
+      //! @{
+
+      //! Returns the k-th child.
+      /**
+       * \returns a reference to the k-th child.
+       */
+      template<std::size_t k>
+      constexpr typename Child<k>::Type& child (index_constant<k> = {})
+      {
+        return std::get<k>(_children);
+      }
+
+      //! Returns the k-th child (const version).
+      /**
+       * \returns a const reference to the k-th child.
+       */
+      template<std::size_t k>
+      constexpr const typename Child<k>::Type& child (index_constant<k> = {}) const
+      {
+        return std::get<k>(_children);
+      }
+
+      //! Store the passed value in k-th child.
+      template<std::size_t k>
+      constexpr void setChild (typename Child<k>::Type child, index_constant<k> = {})
+      {
+        std::get<k>(_children) = std::move(child);
+      }
+
+      constexpr const NodeStorage& nodeStorage () const
+      {
+        return _children;
+      }
+
+      //! @}
+
+      //! @name Nested Child Access
+      //! @{
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i)
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! Returns the child given by the list of indices.
+      /**
+       * This method simply forwards to the freestanding function child(). See that
+       * function for further information.
+       */
+#ifdef DOXYGEN
+      template<typename... Indices>
+      const ImplementationDefined& child (Indices... indices)
+#else
+      template<typename I0, typename... I,
+        std::enable_if_t<(sizeof...(I) > 0) || IsTreePath<I0>::value, int > = 0>
+      decltype(auto) child (I0 i0, I... i) const
+#endif
+      {
+        static_assert(sizeof...(I) > 0 || impl::_non_empty_tree_path(I0{}),
+          "You cannot use the member function child() with an empty TreePath, use the freestanding version child(node,treePath) instead."
+          );
+        return Dune::TypeTree::child(*this,i0,i...);
+      }
+
+      //! @}
+
+    protected:
+
+      //! @name Constructors
+      //! @{
+
+      //! Default constructor, which value-initializes all children.
+      constexpr ValueCompositeNode ()
+        : _children{}
+      {}
+
+      //! Initialize all children with the passed-in objects.
+      template<typename... Args, typename = typename std::enable_if<(sizeof...(Args) == degree())>::type>
+      constexpr ValueCompositeNode (Args&&... args)
+        : _children(std::forward<Args>(args)...)
+      {}
+
+      //! Initialize the ValueCompositeNode with a copy of the passed-in storage type.
+      explicit constexpr ValueCompositeNode (const NodeStorage& children)
+        : _children(children)
+      {}
+
+      //! @}
+
+    private:
+      NodeStorage _children;
+    };
+
+    //! \} group Nodes
+
+  } // namespace TypeTree
+} //namespace Dune
+
+#endif // DUNE_TYPETREE_VALUENODES_HH
@@ -0,0 +1,96 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+// Compile-time and run-time benchmark for StaticTraversalThreshold. The program traverses power
+// nodes of leaves with different degrees many times with a static visitor and prints the time
+// per leaf. The threshold is set by the macro STATIC_DEGREE_THRESHOLD, without it all children
+// are traversed with static indices. There is one target per threshold, and the time needed to
+// build it measures the compile-time cost, e.g.
+//
+//   time make statictraversalbenchmark_4 && ./statictraversalbenchmark_4
+//   time make statictraversalbenchmark && ./statictraversalbenchmark
+//
+// The targets are not part of the default build.
+
+#include "config.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+#ifdef STATIC_DEGREE_THRESHOLD
+struct Traversal
+  : public Dune::TypeTree::StaticTraversal
+  , public Dune::TypeTree::StaticTraversalThreshold<STATIC_DEGREE_THRESHOLD>
+{};
+#else
+struct Traversal
+  : public Dune::TypeTree::StaticTraversal
+{};
+#endif
+
+// weights the leaf values with the last tree path entry, which is static below the threshold,
+// and updates them, so the compiler cannot hoist the traversal out of the benchmark loop
+struct WeightedLeafSum
+  : public Dune::TypeTree::TreeVisitor
+  , public Traversal
+{
+  WeightedLeafSum(long& s) : sum(s) {}
+
+  template<class T, class TreePath>
+  void leaf(T&& t, TreePath tp)
+  {
+    sum += t.value * (std::size_t(tp.back()) + 1);
+    t.value = int(sum & 0xff);
+  }
+
+  long& sum;
+};
+
+template<std::size_t degree>
+void benchmark()
+{
+  // a composite of two power nodes, so the traversal of the power node is not the root
+  using Vector = Power<ValueLeaf,degree>;
+  using Tree = Composite<Vector,Vector>;
+
+  typename Vector::NodeStorage children;
+  for (std::size_t i = 0; i < degree; ++i)
+    children[i] = std::make_shared<ValueLeaf>(int(i));
+  Tree tree(std::make_shared<Vector>(children),std::make_shared<Vector>(children));
+
+  const std::size_t n = 20000000 / degree;
+  long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < n; ++i)
+    Dune::TypeTree::applyToTree(tree,WeightedLeafSum(sum));
+  std::chrono::duration<double,std::nano> time = std::chrono::steady_clock::now() - start;
+
+  std::cout << "degree " << degree << ": " << time.count() / (n * 2 * degree)
+            << " ns per leaf (checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+#ifdef STATIC_DEGREE_THRESHOLD
+  std::cout << "static degree threshold " << STATIC_DEGREE_THRESHOLD << std::endl;
+#else
+  std::cout << "no static degree threshold" << std::endl;
+#endif
+
+  benchmark<4>();
+  benchmark<16>();
+  benchmark<64>();
+  benchmark<256>();
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/accumulate_static.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+// counts the leaves
+struct LeafCount
+{
+  typedef std::size_t result_type;
+
+  template<typename Node, typename TreePath>
+  struct doVisit
+  {
+    static const bool value = Node::isLeaf;
+  };
+
+  template<typename Node, typename TreePath>
+  struct visit
+  {
+    static const result_type result = 1;
+  };
+};
+
+// computes the depth of the tree
+struct Depth
+{
+  typedef std::size_t result_type;
+
+  template<typename Node, typename TreePath>
+  struct doVisit
+  {
+    static const bool value = true;
+  };
+
+  template<typename Node, typename TreePath>
+  struct visit
+  {
+    static const result_type result = Dune::TypeTree::treePathSize(TreePath{});
+  };
+};
+
+// keeps the type of the first leaf
+struct FirstLeafType
+{
+  template<typename Node, typename TreePath>
+  struct doVisit
+  {
+    static const bool value = Node::isLeaf;
+  };
+
+  template<typename Node, typename TreePath>
+  struct visit
+  {
+    typedef Node type;
+  };
+};
+
+struct KeepFirst
+{
+  template<typename T1, typename T2>
+  struct reduce
+  {
+    typedef std::conditional_t<std::is_void_v<T1>,T2,T1> type;
+  };
+};
+
+int main()
+{
+  using Dune::TypeTree::DynamicAccumulateValue;
+  using Dune::TypeTree::plus;
+  using Dune::TypeTree::max;
+
+  Dune::TestSuite test("accumulate value");
+
+  using Vector = Power<Leaf,3>;
+
+  {
+    // static trees give the compile-time result
+    using Tree = Composite<Vector,Leaf>;
+    using Accumulate = DynamicAccumulateValue<Tree,LeafCount,plus<std::size_t>,0>;
+    static_assert(Accumulate::isStatic);
+    Tree tree{Vector(Leaf(),Leaf(),Leaf()),Leaf()};
+    test.check(Accumulate::result(tree) == 4) << "Wrong leaf count for static tree";
+    test.check(Accumulate::result(tree) == Dune::TypeTree::AccumulateValue<Tree,LeafCount,plus<std::size_t>,0>::result)
+      << "Result differs from AccumulateValue";
+  }
+
+  {
+    using Tree = Composite<Vector,DynamicPower<Composite<Leaf,DynamicPower<Leaf>>>>;
+    using Inner = Composite<Leaf,DynamicPower<Leaf>>;
+    Tree tree{Vector(Leaf(),Leaf(),Leaf()),
+              DynamicPower<Inner>(Inner(Leaf(),DynamicPower<Leaf>(Leaf(),Leaf())),
+                                  Inner(Leaf(),DynamicPower<Leaf>(std::size_t(0))))};
+
+    using Count = DynamicAccumulateValue<Tree,LeafCount,plus<std::size_t>,0>;
+    static_assert(not Count::isStatic);
+    test.check(Count::result(tree) == 7) << "Wrong leaf count for dynamic tree";
+
+    using MaxDepth = DynamicAccumulateValue<Tree,Depth,max<std::size_t>,0>;
+    test.check(MaxDepth::result(tree) == 4) << "Wrong depth of dynamic tree";
+  }
+
+  {
+    using Tree = Composite<DynamicPower<Vector>,Leaf>;
+    using Policy = Dune::TypeTree::TypeAccumulationPolicy<FirstLeafType,KeepFirst,void>;
+    static_assert(std::is_same_v<Dune::TypeTree::AccumulateType<Tree,Policy>::type,Leaf>);
+  }
+
+  return test.exit();
+}
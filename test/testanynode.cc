@@ -0,0 +1,86 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/anynode.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct OtherLeaf : public Dune::TypeTree::LeafNode {};
+
+// prints the structure of a tree, instantiated once for all trees
+struct PrintVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  void pre(Dune::TypeTree::AnyNode node, std::span<const std::size_t>)
+  {
+    out << (node.isPower() ? "P" : "C") << node.degree() << "(";
+  }
+
+  void post(Dune::TypeTree::AnyNode, std::span<const std::size_t>)
+  {
+    out << ")";
+  }
+
+  void leaf(Dune::TypeTree::AnyNode node, std::span<const std::size_t> treePath)
+  {
+    out << "L";
+    for (auto i : treePath)
+      out << i;
+    if (auto leaf = node.target<ValueLeaf>())
+      out << "=" << leaf->value;
+  }
+
+  std::ostringstream out;
+};
+
+std::string print(Dune::TypeTree::AnyNode tree)
+{
+  PrintVisitor visitor;
+  Dune::TypeTree::applyToAnyTree(tree,visitor);
+  return visitor.out.str();
+}
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("AnyNode");
+
+  using Tree = Composite<Power<ValueLeaf,2>,DynamicPower<ValueLeaf>,OtherLeaf>;
+  Tree tree{Power<ValueLeaf,2>(ValueLeaf(1),ValueLeaf(2)),DynamicPower<ValueLeaf>(ValueLeaf(3)),OtherLeaf()};
+
+  Dune::TypeTree::AnyNode node(tree);
+  test.check(node.isComposite() and not node.isLeaf() and not node.isPower()) << "Wrong node kind";
+  test.check(node.degree() == 3) << "Wrong degree";
+  test.check(node.type() == typeid(Tree)) << "Wrong type";
+  test.check(node.child(1).nodeTag() == typeid(Dune::TypeTree::DynamicPowerNodeTag)) << "Wrong node tag";
+  test.check(node.child(0).child(1).target<ValueLeaf>() == &tree.child(_0).child(1)) << "Wrong child";
+  test.check(node.child(2).target<ValueLeaf>() == nullptr) << "target() ignores the type";
+  test.check(node.child(2) == Dune::TypeTree::AnyNode(tree.child(_2))) << "Wrong comparison";
+
+  test.check(print(tree) == "C3(P2(L00=1L01=2)P1(L10=3)L2)") << "Wrong traversal: " << print(tree);
+
+  // the same code handles trees of other types
+  test.check(print(Power<OtherLeaf,1>(OtherLeaf())) == "P1(L0)") << "Wrong traversal of another tree";
+  test.check(print(ValueLeaf(4)) == "L=4") << "Wrong traversal of a leaf";
+
+  return test.exit();
+}
@@ -0,0 +1,81 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/batchtraversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+// sums the leaf values over all trees for each leaf position
+template<class Traversal>
+struct SumVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Traversal
+{
+  template<class Nodes, class TreePath>
+  void pre(const Nodes& nodes, TreePath)
+  {
+    ++innerNodes;
+  }
+
+  template<class Leaves, class TreePath>
+  void leaf(const Leaves& leaves, TreePath treePath)
+  {
+    int sum = 0;
+    for (std::size_t e = 0; e < leaves.size(); ++e)
+      sum += leaves[e].value;
+    sums.push_back(sum);
+    pathsOk = pathsOk and (&leaves[leaves.size()-1] == &Dune::TypeTree::child(leaves.trees().back(),treePath));
+  }
+
+  std::vector<int> sums;
+  std::size_t innerNodes = 0;
+  bool pathsOk = true;
+};
+
+int main()
+{
+  Dune::TestSuite test("batch traversal");
+
+  using Tree = Composite<Power<ValueLeaf,2>,DynamicPower<ValueLeaf>>;
+  std::vector<Tree> trees;
+  for (int e = 0; e < 4; ++e)
+    trees.push_back(Tree{Power<ValueLeaf,2>(ValueLeaf(e),ValueLeaf(10*e)),DynamicPower<ValueLeaf>(ValueLeaf(100*e))});
+
+  {
+    SumVisitor<Dune::TypeTree::StaticTraversal> visitor;
+    Dune::TypeTree::applyToTreeBatch(std::span<const Tree>(trees),visitor);
+    // each position is visited once for the whole batch
+    test.check(visitor.innerNodes == 3) << "Wrong number of inner node visits";
+    test.check(visitor.sums == std::vector<int>{6,60,600}) << "Wrong leaf sums";
+    test.check(visitor.pathsOk) << "Wrong tree paths";
+  }
+
+  {
+    SumVisitor<Dune::TypeTree::DynamicTraversal> visitor;
+    Dune::TypeTree::applyToTreeBatch(std::span(trees),visitor);
+    test.check(visitor.sums == std::vector<int>{6,60,600}) << "Wrong leaf sums with dynamic traversal";
+  }
+
+  {
+    SumVisitor<Dune::TypeTree::StaticTraversal> visitor;
+    Dune::TypeTree::applyToTreeBatch(std::span(trees).first(0),visitor);
+    test.check(visitor.innerNodes == 0 and visitor.sums.empty()) << "Empty batch was visited";
+  }
+
+  return test.exit();
+}
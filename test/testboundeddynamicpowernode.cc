@@ -0,0 +1,93 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/boundeddynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/fixedcapacitystack.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/utility.hh>
+
+#include "typetreetestnodes.hh"
+
+template<class T, std::size_t n>
+struct BoundedPower : public Dune::TypeTree::BoundedDynamicPowerNode<T,n>
+{
+  template<class... C>
+  BoundedPower(C&&... c) : Dune::TypeTree::BoundedDynamicPowerNode<T,n>(std::forward<C>(c)...) {}
+};
+
+template<class Node>
+constexpr bool hasMaxDegree = requires { Dune::TypeTree::MaxDegree<Node>::value; };
+
+using Components = BoundedPower<ValueLeaf,8>;
+using Tree = Composite<BoundedPower<Power<ValueLeaf,2>,4>,ValueLeaf>;
+
+static_assert(Dune::TypeTree::MaxDegree<Components>::value == 8);
+static_assert(Dune::TypeTree::MaxDegree<Power<ValueLeaf,2>>::value == 2);
+static_assert(not hasMaxDegree<Dune::TypeTree::DynamicPowerNode<ValueLeaf>>);
+
+// the bounds of the tree are known at compile time
+using Info = Dune::TypeTree::TreeInfo<Tree>;
+static_assert(Info::depth == 4);
+static_assert(Info::leafCount == 4*2 + 1);
+static_assert(Info::nodeCount == 1 + 1 + 4*3 + 1);
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("BoundedDynamicPowerNode");
+
+  Components components(ValueLeaf(1),ValueLeaf(2),ValueLeaf(3));
+  test.check(components.degree() == 3) << "Wrong degree";
+  test.check(components.nodeStorage().capacity() == 8) << "Wrong capacity";
+  test.check(components.child(2).value == 3) << "Wrong child";
+
+  components.setChild(1,std::make_shared<ValueLeaf>(4));
+  test.check(components.child(1).value == 4) << "setChild() failed";
+
+  Components sized(std::size_t(5));
+  test.check(sized.degree() == 5) << "Wrong degree of sized node";
+
+  bool thrown = false;
+  try {
+    Components tooLarge(std::size_t(9));
+  } catch (const Dune::RangeError&) {
+    thrown = true;
+  }
+  test.check(thrown) << "Exceeding the capacity did not throw";
+
+  // traversal treats the node like a DynamicPowerNode
+  Tree tree{BoundedPower<Power<ValueLeaf,2>,4>(Power<ValueLeaf,2>(ValueLeaf(1),ValueLeaf(2)),Power<ValueLeaf,2>(ValueLeaf(3),ValueLeaf(4))),ValueLeaf(5)};
+  int sum = 0;
+  std::size_t maxDepth = 0;
+  Dune::TypeTree::forEachLeafNode(tree, [&](const ValueLeaf& leaf, auto treePath) {
+    sum += leaf.value;
+    maxDepth = std::max<std::size_t>(maxDepth,treePath.size());
+  });
+  test.check(sum == 15) << "Wrong traversal";
+
+  // the depth bound sizes stacks for iterative traversals
+  Dune::TypeTree::FixedCapacityStack<std::size_t,Info::depth> stack;
+  for (std::size_t i = 0; i <= maxDepth; ++i)
+    stack.push_back(i);
+  test.check(stack.size() == maxDepth + 1) << "Stack sized by TreeInfo is too small";
+
+  return test.exit();
+}
@@ -66,6 +66,9 @@ void testFilteredCompositeNode(Node& node, Filter filter)
             << "nodes: " << Info::nodeCount(filteredNode) << std::endl
             << "leafs: " << Info::leafCount(filteredNode) << std::endl;
 
+  if constexpr (not std::is_const_v<Node>)
+    assert(&filteredNode.childStorageRef(Dune::Indices::_0) == &node.childStorageRef(Dune::index_constant<FN::template Child<0>::mapped_index>{}));
+
   typedef Dune::TypeTree::TransformTree<FN,TestTransformation> Transformation;
 
   typedef typename Transformation::Type TFN;
@@ -0,0 +1,131 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/transformation.hh>
+#include <dune/typetree/flatteningtransformation.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+#include <dune/typetree/treepath.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Flatten {};
+
+Dune::TypeTree::IdentityNodeTransformation<ValueLeaf,Flatten>
+registerNodeTransformation(ValueLeaf*, Flatten*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleCompositeNodeTransformation<T,Flatten,Composite>
+registerNodeTransformation(T*, Flatten*, Dune::TypeTree::CompositeNodeTag*);
+
+template<class T>
+Dune::TypeTree::FlatteningPowerNodeTransformation<T,Flatten,Power>
+registerNodeTransformation(T*, Flatten*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::FlatteningDynamicPowerNodeTransformation<T,Flatten,DynamicPower>
+registerNodeTransformation(T*, Flatten*, Dune::TypeTree::DynamicPowerNodeTag*);
+
+using Dune::TypeTree::treePath;
+using Dune::TypeTree::flatTreePath;
+using Dune::TypeTree::nestedTreePath;
+using namespace Dune::Indices;
+
+// static paths are mapped to static paths
+static_assert(std::is_same_v<decltype(flatTreePath(treePath(_1,_2),_3)),decltype(treePath(_5))>);
+static_assert(std::is_same_v<decltype(nestedTreePath(treePath(_5),_3)),decltype(treePath(_1,_2))>);
+static_assert(flatTreePath(treePath(1,2,_0),_3) == treePath(5,_0));
+static_assert(nestedTreePath(treePath(5,_0),3) == treePath(1,2,_0));
+
+int main()
+{
+  Dune::TestSuite test("flattening transformation");
+
+  {
+    using Vector = Power<ValueLeaf,3>;
+    using Tree = Power<Vector,2>;
+    auto tree = std::make_shared<const Tree>(Vector(ValueLeaf(0),ValueLeaf(1),ValueLeaf(2)),Vector(ValueLeaf(3),ValueLeaf(4),ValueLeaf(5)));
+
+    using Transform = Dune::TypeTree::TransformTree<Tree,Flatten>;
+    static_assert(std::is_same_v<Transform::transformed_type,Power<ValueLeaf,6>>);
+
+    auto flat = Transform::transform_storage(tree,Flatten{});
+    test.check(flat->degree() == 6) << "Wrong degree of flattened node";
+    for (std::size_t i = 0; i < 2; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        auto flatPath = flatTreePath(treePath(i,j),_3);
+        test.check(&flat->child(flatPath) == &tree->child(i,j))
+          << "Flattened node does not share child " << treePath(i,j);
+        test.check(nestedTreePath(flatPath,_3) == treePath(i,j))
+          << "nestedTreePath() does not invert flatTreePath()";
+      }
+
+    auto copy = Transform::transform(*tree);
+    test.check(&copy.child(4) == &tree->child(1,1)) << "transform() does not share the children";
+  }
+
+  {
+    using Vector = DynamicPower<ValueLeaf>;
+    using Tree = DynamicPower<Vector>;
+    auto tree = std::make_shared<const Tree>(Vector(ValueLeaf(0),ValueLeaf(1)),Vector(ValueLeaf(2),ValueLeaf(3)),Vector(ValueLeaf(4),ValueLeaf(5)));
+
+    auto flat = Dune::TypeTree::TransformTree<Tree,Flatten>::transform_storage(tree,Flatten{});
+    test.check(flat->degree() == 6) << "Wrong degree of flattened node";
+    for (std::size_t k = 0; k < flat->degree(); ++k)
+      test.check(flat->child(k).value == int(k)) << "Wrong order of flattened children";
+    test.check(&flat->child(flatTreePath(treePath(2,1),2)[_0]) == &tree->child(2).child(1))
+      << "Flattened node does not share the children";
+
+    // the children must have the same degree
+    auto ragged = std::make_shared<const Tree>(Vector(ValueLeaf(0),ValueLeaf(1)),Vector(ValueLeaf(2)));
+    bool thrown = false;
+    try {
+      Dune::TypeTree::TransformTree<Tree,Flatten>::transform_storage(ragged,Flatten{});
+    } catch (const Dune::RangeError&) {
+      thrown = true;
+    }
+    test.check(thrown) << "Flattening a ragged node did not throw";
+  }
+
+  {
+    // power nodes that cannot be flattened are left unchanged next to flattened ones
+    using Vector = Power<ValueLeaf,3>;
+    using Mixed = Power<DynamicPower<ValueLeaf>,2>;
+    using Tree = Composite<Power<Vector,2>,Power<ValueLeaf,2>,DynamicPower<ValueLeaf>,Mixed,ValueLeaf>;
+    auto tree = std::make_shared<const Tree>(
+      Power<Vector,2>(Vector(ValueLeaf(0),ValueLeaf(1),ValueLeaf(2)),Vector(ValueLeaf(3),ValueLeaf(4),ValueLeaf(5))),
+      Power<ValueLeaf,2>(ValueLeaf(6),ValueLeaf(7)),
+      DynamicPower<ValueLeaf>(ValueLeaf(8)),
+      Mixed(DynamicPower<ValueLeaf>(ValueLeaf(9)),DynamicPower<ValueLeaf>(ValueLeaf(10))),
+      ValueLeaf(11));
+
+    using Transform = Dune::TypeTree::TransformTree<Tree,Flatten>;
+    static_assert(std::is_same_v<Transform::transformed_type,Composite<Power<ValueLeaf,6>,Power<ValueLeaf,2>,DynamicPower<ValueLeaf>,Mixed,ValueLeaf>>);
+
+    auto flat = Transform::transform_storage(tree,Flatten{});
+    test.check(&flat->child(_0).child(5) == &tree->child(_0).child(1).child(2))
+      << "Nested power node in a composite node was not flattened";
+    test.check(flat->childStorage(_1) == tree->childStorage(_1)) << "Power node of leaves was not left unchanged";
+    test.check(flat->childStorage(_2) == tree->childStorage(_2)) << "Dynamic power node of leaves was not left unchanged";
+    test.check(flat->childStorage(_3) == tree->childStorage(_3)) << "Power node of dynamic power nodes was not left unchanged";
+    test.check(flat->childStorage(_4) == tree->childStorage(_4)) << "Leaf was not left unchanged";
+  }
+
+  return test.exit();
+}
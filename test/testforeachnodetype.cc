@@ -0,0 +1,107 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <array>
+#include <cstddef>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/filteredcompositenode.hh>
+#include <dune/typetree/filters.hh>
+#include <dune/typetree/proxynode.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+
+#include "typetreetestnodes.hh"
+
+template<std::size_t n>
+struct Block : public Dune::TypeTree::LeafNode
+{
+  static constexpr std::size_t blockSize = n;
+};
+
+using Velocity = Power<Block<2>,3>;
+using Tree = Composite<Velocity,Block<1>>;
+
+// the offsets of the leaves in a blocked vector, computed without a tree object
+template<class T>
+constexpr auto leafOffsets()
+{
+  std::array<std::size_t,4> offsets = {};
+  std::size_t leaf = 0, offset = 0;
+  Dune::TypeTree::forEachNodeType<T>([&](auto node, auto) {
+    using Node = typename decltype(node)::type;
+    if constexpr (Node::isLeaf) {
+      offsets[leaf++] = offset;
+      offset += Node::blockSize;
+    }
+  });
+  return offsets;
+}
+
+template<class T>
+constexpr std::size_t nodeCount()
+{
+  std::size_t count = 0;
+  Dune::TypeTree::forEachNodeType<T>([&](auto, auto) { ++count; });
+  return count;
+}
+
+template<class... T>
+constexpr bool isStatic(const Dune::TypeTree::HybridTreePath<T...>&)
+{
+  return (Dune::IsIntegralConstant<T>::value and ...);
+}
+
+// the tree paths passed to the function are fully static
+template<class T>
+constexpr bool staticTreePaths()
+{
+  bool result = true;
+  Dune::TypeTree::forEachNodeType<T>([&](auto, auto treePath) {
+    result = result and isStatic(treePath);
+  });
+  return result;
+}
+
+static_assert(leafOffsets<Tree>() == std::array<std::size_t,4>{0,2,4,6});
+static_assert(leafOffsets<const Tree>() == std::array<std::size_t,4>{0,2,4,6});
+static_assert(nodeCount<Tree>() == 6);
+static_assert(staticTreePaths<Tree>());
+
+using Proxy = Dune::TypeTree::ProxyNode<Tree>;
+static_assert(nodeCount<Proxy>() == 6);
+static_assert(leafOffsets<Proxy>() == std::array<std::size_t,4>{0,2,4,6});
+
+using Filtered = Dune::TypeTree::FilteredCompositeNode<const Tree,Dune::TypeTree::IndexFilter<1,0>>;
+static_assert(nodeCount<Filtered>() == 6);
+static_assert(leafOffsets<Filtered>() == std::array<std::size_t,4>{0,1,3,5});
+
+int main()
+{
+  Dune::TestSuite test("forEachNodeType");
+
+  // the tree paths of the leaves match leafTreePathTuple()
+  auto expected = Dune::TypeTree::leafTreePathTuple<Tree,Dune::TypeTree::TreePathType::fullyStatic>();
+  std::size_t leaf = 0;
+  Dune::TypeTree::forEachNodeType<Tree>([&](auto node, auto treePath) {
+    if constexpr (decltype(node)::type::isLeaf) {
+      Dune::Hybrid::forEach(Dune::range(Dune::index_constant<4>{}), [&](auto i) {
+        if (i == leaf)
+          test.check(treePath == std::get<i>(expected)) << "Wrong tree path of leaf " << leaf;
+      });
+      ++leaf;
+    }
+  });
+  test.check(leaf == 4) << "Wrong number of leaves";
+
+  return test.exit();
+}
@@ -0,0 +1,104 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/freeze.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+// records the addresses and leaf values in traversal order
+struct NodeRecorder
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class Node, class TreePath>
+  void pre(const Node& node, TreePath)
+  {
+    addresses.push_back(&node);
+  }
+
+  template<class Leaf, class TreePath>
+  void leaf(const Leaf& leaf, TreePath)
+  {
+    addresses.push_back(&leaf);
+    values.push_back(leaf.value);
+  }
+
+  std::vector<const void*> addresses;
+  std::vector<int> values;
+};
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("freeze");
+
+  using Vector = Power<ValueLeaf,2>;
+  using Vectors = DynamicPower<Vector>;
+  using Tree = Composite<Vector,ValueLeaf,Vectors>;
+
+  auto tree = std::make_shared<Tree>(Vector(ValueLeaf(1),ValueLeaf(2)),
+                                     ValueLeaf(3),
+                                     Vectors(Vector(ValueLeaf(4),ValueLeaf(5))));
+
+  // replace some nodes to scatter them across the heap
+  std::vector<std::shared_ptr<ValueLeaf>> padding;
+  for (int i = 0; i < 16; ++i)
+    padding.push_back(std::make_shared<ValueLeaf>(i));
+  tree->child(_0).setChild(0,std::make_shared<ValueLeaf>(10));
+  tree->child(_2,0).setChild(_1,ValueLeaf(20));
+
+  NodeRecorder original;
+  Dune::TypeTree::applyToTree(*tree,original);
+
+  std::shared_ptr<const Tree> frozen = Dune::TypeTree::freeze(*tree);
+
+  NodeRecorder recorder;
+  Dune::TypeTree::applyToTree(*frozen,recorder);
+
+  test.check(recorder.values == original.values) << "Frozen tree has different leaf values";
+  test.check(recorder.addresses.size() == 9) << "Frozen tree has a different number of nodes";
+
+  // nodes are laid out in traversal order
+  for (std::size_t i = 1; i < recorder.addresses.size(); ++i)
+    test.check(recorder.addresses[i-1] < recorder.addresses[i])
+      << "Node " << i << " of frozen tree is not laid out in traversal order";
+
+  // freezing again uses the requests recorded for the node types and fills the buffer exactly
+  auto again = Dune::TypeTree::freeze(*tree);
+  test.check(again->child(_2,0,_1).value == 20) << "Second frozen tree has different leaf values";
+
+  // the frozen tree does not share any nodes with the original tree
+  for (auto address : recorder.addresses)
+    for (auto originalAddress : original.addresses)
+      test.check(address != originalAddress) << "Frozen tree shares nodes with the original tree";
+
+  // the frozen tree outlives the original tree
+  tree.reset();
+  NodeRecorder after;
+  Dune::TypeTree::applyToTree(*frozen,after);
+  test.check(after.values == original.values) << "Frozen tree does not outlive the original tree";
+
+  // the buffer stays alive as long as any node of the frozen tree
+  auto subtree = frozen->childStorage(_2);
+  frozen.reset();
+  test.check(subtree->child(0).child(_1).value == 20) << "Frozen subtree does not keep the buffer alive";
+
+  return test.exit();
+}
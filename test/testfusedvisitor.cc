@@ -0,0 +1,141 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+using Vector = Power<Leaf,2>;
+
+// rejects the children of power nodes
+struct SkipPowerChildren
+{
+  template<class Node, class Child, class TreePath>
+  struct VisitChild
+  {
+    static const bool value = not std::decay_t<Node>::isPower;
+  };
+};
+
+// records all callbacks as strings
+template<class VisitMixin, class TraversalMixin>
+struct Recorder
+  : public Dune::TypeTree::DefaultVisitor
+  , public VisitMixin
+  , public TraversalMixin
+{
+  template<class T, class TreePath>
+  void pre(T&&, TreePath tp) { record("pre",tp); }
+
+  template<class T, class TreePath>
+  void in(T&&, TreePath tp) { record("in",tp); }
+
+  template<class T, class TreePath>
+  void post(T&&, TreePath tp) { record("post",tp); }
+
+  template<class T, class TreePath>
+  void leaf(T&&, TreePath tp) { record("leaf",tp); }
+
+  template<class T, class Child, class TreePath, class ChildIndex>
+  void beforeChild(T&&, Child&&, TreePath tp, ChildIndex i) { record("before",tp,i); }
+
+  template<class T, class Child, class TreePath, class ChildIndex>
+  void afterChild(T&&, Child&&, TreePath tp, ChildIndex i) { record("after",tp,i); }
+
+  template<class TreePath, class... I>
+  void record(const char* callback, TreePath tp, I... i)
+  {
+    std::ostringstream s;
+    s << callback << " [";
+    for (std::size_t k = 0; k < tp.size(); ++k)
+      s << " " << tp[k];
+    s << " ]";
+    ((s << " " << std::size_t(i)), ...);
+    events.push_back(s.str());
+  }
+
+  std::vector<std::string> events;
+};
+
+using TreeRecorder = Recorder<Dune::TypeTree::VisitTree,Dune::TypeTree::DynamicTraversal>;
+using StaticTreeRecorder = Recorder<Dune::TypeTree::VisitTree,Dune::TypeTree::StaticTraversal>;
+using DirectChildrenRecorder = Recorder<Dune::TypeTree::VisitDirectChildren,Dune::TypeTree::StaticTraversal>;
+using SkippingRecorder = Recorder<SkipPowerChildren,Dune::TypeTree::DynamicTraversal>;
+
+int main()
+{
+  Dune::TestSuite test("fused visitor");
+
+  using Tree = Composite<Vector,Leaf,DynamicPower<Vector>>;
+  Tree tree{Vector(Leaf(),Leaf()),
+            Leaf(),
+            DynamicPower<Vector>(Vector(Leaf(),Leaf()),Vector(Leaf(),Leaf()))};
+
+  // reference results of separate traversals
+  TreeRecorder treeRef;
+  DirectChildrenRecorder directRef;
+  SkippingRecorder skippingRef;
+  Dune::TypeTree::applyToTree(tree,treeRef);
+  Dune::TypeTree::applyToTree(tree,directRef);
+  Dune::TypeTree::applyToTree(tree,skippingRef);
+
+  {
+    TreeRecorder treeRecorder;
+    DirectChildrenRecorder directRecorder;
+    SkippingRecorder skippingRecorder;
+    auto fused = Dune::TypeTree::fuse(treeRecorder,directRecorder,skippingRecorder);
+    static_assert(decltype(fused)::treePathType == Dune::TypeTree::TreePathType::dynamic);
+    Dune::TypeTree::applyToTree(tree,fused);
+
+    test.check(treeRecorder.events == treeRef.events)
+      << "Fused traversal differs for full tree visitor";
+    test.check(directRecorder.events == directRef.events)
+      << "Fused traversal differs for direct children visitor";
+    test.check(skippingRecorder.events == skippingRef.events)
+      << "Fused traversal differs for visitor skipping power node children";
+  }
+
+  {
+    // without a full tree visitor, subtrees rejected by all components are skipped
+    DirectChildrenRecorder directRecorder;
+    auto fused = Dune::TypeTree::fuse(directRecorder,SkippingRecorder{});
+    Dune::TypeTree::applyToTree(tree,fused);
+    test.check(directRecorder.events == directRef.events)
+      << "Fused traversal differs for direct children visitor";
+    test.check(fused.visitor(Dune::Indices::_1).events == skippingRef.events)
+      << "Fused traversal differs for visitor stored by value";
+  }
+
+  {
+    // static traversal is used if all components request it
+    StaticTreeRecorder staticRef;
+    Dune::TypeTree::applyToTree(tree,staticRef);
+
+    StaticTreeRecorder staticRecorder;
+    auto fused = Dune::TypeTree::fuse(staticRecorder,DirectChildrenRecorder{});
+    static_assert(decltype(fused)::treePathType == Dune::TypeTree::TreePathType::fullyStatic);
+    Dune::TypeTree::applyToTree(tree,fused);
+    test.check(staticRecorder.events == staticRef.events)
+      << "Fused traversal differs for static visitor";
+  }
+
+  return test.exit();
+}
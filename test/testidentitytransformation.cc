@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/transformation.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode
+{
+  typedef Dune::TypeTree::LeafNodeTag ImplementationTag;
+};
+
+struct Pressure : public Dune::TypeTree::LeafNode
+{
+  typedef Dune::TypeTree::LeafNodeTag ImplementationTag;
+};
+
+struct TransformedPressure : public Dune::TypeTree::LeafNode {};
+
+// transforms the pressure leaves and leaves all other nodes unchanged
+struct PressureTransformation {};
+
+Dune::TypeTree::IdentityNodeTransformation<Leaf,PressureTransformation>
+registerNodeTransformation(Leaf*, PressureTransformation*, Dune::TypeTree::LeafNodeTag*);
+
+Dune::TypeTree::SimpleLeafNodeTransformation<Pressure,PressureTransformation,TransformedPressure>
+registerNodeTransformation(Pressure*, PressureTransformation*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimplePowerNodeTransformation<T,PressureTransformation,Power>
+registerNodeTransformation(T*, PressureTransformation*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleDynamicPowerNodeTransformation<T,PressureTransformation,DynamicPower>
+registerNodeTransformation(T*, PressureTransformation*, Dune::TypeTree::DynamicPowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleCompositeNodeTransformation<T,PressureTransformation,Composite>
+registerNodeTransformation(T*, PressureTransformation*, Dune::TypeTree::CompositeNodeTag*);
+
+// a composite node with a descriptor that is not stateless, e.g. because it labels the node
+template<class... T>
+struct Labelled : public Composite<T...>
+{
+  using Composite<T...>::Composite;
+};
+
+template<class... T>
+struct LabellingTransformation
+  : public Dune::TypeTree::SimpleCompositeNodeTransformation<Labelled<T...>,PressureTransformation,Labelled>
+{
+  static const bool stateless = false;
+};
+
+template<class... T>
+LabellingTransformation<T...>
+registerNodeTransformation(Labelled<T...>*, PressureTransformation*, Dune::TypeTree::CompositeNodeTag*);
+
+// leaves every node unchanged
+struct Identity {};
+
+template<class T, class Tag>
+Dune::TypeTree::IdentityNodeTransformation<T,Identity>
+registerNodeTransformation(T*, Identity*, Tag*);
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("identity transformation");
+
+  using Velocity = Power<Leaf,2>;
+  using Tree = Composite<Velocity,DynamicPower<Leaf>,Pressure,Composite<Leaf>,Labelled<Leaf>>;
+  auto tree = std::make_shared<const Tree>(Velocity(Leaf(),Leaf()),DynamicPower<Leaf>(Leaf()),Pressure(),Composite<Leaf>(Leaf()),Labelled<Leaf>(Leaf()));
+
+  {
+    using Transform = Dune::TypeTree::TransformTree<Tree,PressureTransformation>;
+    static_assert(std::is_same_v<Transform::transformed_type,Composite<Velocity,DynamicPower<Leaf>,TransformedPressure,Composite<Leaf>,Labelled<Leaf>>>);
+
+    // the subtrees without pressure leaves are rebuilt unchanged by the stateless descriptors, so they are shared
+    auto transformed = Transform::transform_storage(tree);
+    test.check(transformed->childStorage(_0) == tree->childStorage(_0)) << "Unchanged power node was rebuilt";
+    test.check(transformed->childStorage(_1) == tree->childStorage(_1)) << "Unchanged dynamic power node was rebuilt";
+    test.check(transformed->childStorage(_3) == tree->childStorage(_3)) << "Unchanged composite node was rebuilt";
+
+    // other descriptors that rebuild the source node type are still called, only their unchanged children are shared
+    test.check(transformed->childStorage(_4) != tree->childStorage(_4)) << "Labelled composite node was shared";
+    test.check(transformed->child(_4).childStorage(_0) == tree->child(_4).childStorage(_0)) << "Unchanged leaf was rebuilt";
+
+    auto copy = Transform::transform(*tree);
+    test.check(copy.childStorage(_0) == tree->childStorage(_0)) << "Unchanged power node was rebuilt by transform()";
+  }
+
+  {
+    // a preserved root is copied, but shares its children
+    using Transform = Dune::TypeTree::TransformTree<Velocity,PressureTransformation>;
+    static_assert(std::is_same_v<Transform::transformed_type,Velocity>);
+    auto source = tree->childStorage(_0);
+    auto transformed = Transform::transform_storage(source);
+    test.check(transformed != source) << "Root of the transformed tree was not copied";
+    test.check(transformed->childStorage(0) == source->childStorage(0)) << "Children of the root were not shared";
+  }
+
+  {
+    using Transform = Dune::TypeTree::TransformTree<Tree,Identity>;
+    static_assert(std::is_same_v<Transform::transformed_type,Tree>);
+    auto transformed = Transform::transform_storage(tree);
+    test.check(transformed->childStorage(_2) == tree->childStorage(_2)) << "Children of the identity were not shared";
+  }
+
+  return test.exit();
+}
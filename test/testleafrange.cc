@@ -0,0 +1,137 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/leafrange.hh>
+#include <dune/typetree/traversal.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode
+{
+  int value = 0;
+};
+
+template<class TreePath>
+std::string toString(TreePath tp)
+{
+  std::ostringstream s;
+  s << "[";
+  for (std::size_t i = 0; i < tp.size(); ++i)
+    s << " " << tp[i];
+  s << " ]";
+  return s.str();
+}
+
+// the tree paths of all leaves in the order of forEachLeafNode()
+template<class Tree>
+std::vector<std::string> leafPaths(const Tree& tree)
+{
+  std::vector<std::string> paths;
+  Dune::TypeTree::forEachLeafNode(tree, [&](auto&&, auto tp) {
+    paths.push_back(toString(tp));
+  });
+  return paths;
+}
+
+int main()
+{
+  Dune::TestSuite test("leaf range");
+
+  using Vector = Power<Leaf,3>;
+
+  {
+    // static degrees: random access range
+    using Tree = Power<Vector,2>;
+    Tree tree{Vector(Leaf(),Leaf(),Leaf()),Vector(Leaf(),Leaf(),Leaf())};
+    auto leaves = Dune::TypeTree::leafRange(tree);
+    static_assert(std::ranges::random_access_range<decltype(leaves)>);
+    static_assert(std::ranges::sized_range<decltype(leaves)>);
+    static_assert(decltype(leaves)::size() == 6);
+
+    std::vector<std::string> paths;
+    int i = 0;
+    for (auto [leaf, tp] : leaves) {
+      paths.push_back(toString(tp));
+      leaf.value = i++;
+    }
+    test.check(paths == leafPaths(tree)) << "Wrong leaf order for static tree";
+    test.check(tree.child(1).child(2).value == 5) << "Leaves are not returned by reference";
+    test.check(leaves[4].first.value == 4) << "Wrong random access";
+    test.check(toString(leaves[4].second) == "[ 1 1 ]") << "Wrong tree path for random access";
+
+    auto even = leaves
+      | std::views::filter([](auto entry) { return entry.first.value % 2 == 0; })
+      | std::views::take(2);
+    test.check(std::ranges::distance(even) == 2) << "Range adaptors do not work";
+  }
+
+  {
+    // dynamic degrees: forward range skipping empty nodes
+    using Tree = DynamicPower<DynamicPower<Leaf>>;
+    Tree tree{DynamicPower<Leaf>(Leaf(),Leaf()),
+              DynamicPower<Leaf>(std::size_t(0)),
+              DynamicPower<Leaf>(Leaf())};
+    const Tree& constTree = tree;
+    auto leaves = Dune::TypeTree::leafRange(constTree);
+    static_assert(std::ranges::forward_range<decltype(leaves)>);
+    static_assert(std::is_same_v<decltype(leaves)::Leaf,const Leaf>);
+
+    std::vector<std::string> paths;
+    for (auto [leaf, tp] : leaves)
+      paths.push_back(toString(tp));
+    test.check(paths == leafPaths(tree)) << "Wrong leaf order for dynamic tree";
+    test.check(paths.size() == 3) << "Wrong number of leaves";
+
+    Tree empty{DynamicPower<Leaf>(std::size_t(0))};
+    test.check(Dune::TypeTree::leafRange(empty).empty()) << "Range of empty tree is not empty";
+  }
+
+  static_assert(Dune::TypeTree::UniformLeafTree<Leaf>);
+  static_assert(Dune::TypeTree::UniformLeafTree<DynamicPower<Vector>>);
+  static_assert(not Dune::TypeTree::UniformLeafTree<Composite<Leaf,Leaf>>);
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+  {
+    // generator for general trees
+    using Tree = Composite<Vector,Leaf,DynamicPower<Vector>>;
+    Tree tree{Vector(Leaf(),Leaf(),Leaf()),
+              Leaf(),
+              DynamicPower<Vector>(Vector(Leaf(),Leaf(),Leaf()),Vector(Leaf(),Leaf(),Leaf()))};
+
+    std::vector<std::string> paths;
+    for (const auto& path : Dune::TypeTree::leafGenerator<std::string>(tree, [](auto&&, auto tp) {
+        return toString(tp);
+      }))
+      paths.push_back(path);
+    test.check(paths == leafPaths(tree)) << "Wrong leaf order for generator";
+
+    // stopping early does not visit the remaining leaves
+    std::size_t visited = 0;
+    auto generator = Dune::TypeTree::leafGenerator<std::size_t>(tree, [&](auto&&, auto tp) {
+      return ++visited;
+    });
+    for (std::size_t count : generator)
+      if (count == 2)
+        break;
+    test.check(visited == 2) << "Generator is not lazy";
+  }
+#endif
+
+  return test.exit();
+}
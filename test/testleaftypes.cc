@@ -0,0 +1,68 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/leaftypes.hh>
+#include <dune/typetree/treepath.hh>
+
+#include "typetreetestnodes.hh"
+
+template<int id>
+struct Leaf : public Dune::TypeTree::LeafNode
+{
+  static constexpr int type = id;
+};
+
+using Velocity = Leaf<0>;
+using Pressure = Leaf<1>;
+using Temperature = Leaf<2>;
+using Tree = Composite<Power<Velocity,2>,Pressure,Velocity,Temperature,Pressure>;
+
+using Buckets = Dune::TypeTree::LeafTypeBuckets<Tree>;
+
+static_assert(Buckets::size() == 3);
+static_assert(std::is_same_v<Buckets::Types,std::tuple<Velocity,Pressure,Temperature>>);
+static_assert(std::is_same_v<Buckets::Type<1>,Pressure>);
+static_assert(Buckets::count<0>() == 3);
+static_assert(Buckets::count<1>() == 2);
+static_assert(Buckets::count<2>() == 1);
+
+using namespace Dune::Indices;
+using Dune::TypeTree::treePath;
+
+static_assert(Buckets::treePaths<0>() == std::make_tuple(treePath(_0,_0),treePath(_0,_1),treePath(_2)));
+static_assert(Buckets::treePaths<1>() == std::make_tuple(treePath(_1),treePath(_4)));
+
+int main()
+{
+  Dune::TestSuite test("leaf types");
+
+  Tree tree{Power<Velocity,2>(Velocity(),Velocity()),Pressure(),Velocity(),Temperature(),Pressure()};
+
+  std::vector<int> types;
+  std::vector<const void*> leaves;
+  Dune::TypeTree::forEachLeafNodeByType(tree, [&](const auto& leaf, auto treePath) {
+    types.push_back(leaf.type);
+    leaves.push_back(&leaf);
+    test.check(&leaf == &Dune::TypeTree::child(tree,treePath)) << "Wrong tree path " << treePath;
+  });
+
+  test.check(types == std::vector<int>{0,0,0,1,1,2}) << "Leaves are not grouped by type";
+  test.check(leaves.size() == 6 and leaves[2] == &tree.child(_2)) << "Wrong order of leaves in bucket";
+
+  return test.exit();
+}
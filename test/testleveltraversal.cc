@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/leveltraversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+template<class TreePath>
+std::string toString(TreePath tp)
+{
+  std::ostringstream s;
+  s << "[";
+  for (std::size_t i = 0; i < tp.size(); ++i)
+    s << " " << tp[i];
+  s << " ]";
+  return s.str();
+}
+
+// records the nodes of each level
+template<class TraversalMixin>
+struct LevelRecorder
+  : public Dune::TypeTree::TreeLevelVisitor
+  , public TraversalMixin
+{
+  template<class Depth>
+  void beginLevel(Depth depth)
+  {
+    static_assert(Dune::IsIntegralConstant<Depth>::value);
+    if (depth != levels.size())
+      error = true;
+    levels.emplace_back();
+  }
+
+  template<class Depth>
+  void endLevel(Depth depth)
+  {
+    if (depth + 1 != levels.size())
+      error = true;
+    ++finishedLevels;
+  }
+
+  template<class T, class TreePath>
+  void pre(T&&, TreePath tp)
+  {
+    levels.back().push_back(toString(tp));
+  }
+
+  template<class T, class TreePath>
+  void leaf(T&&, TreePath tp)
+  {
+    levels.back().push_back(toString(tp));
+    ++leafCount;
+  }
+
+  std::vector<std::vector<std::string>> levels;
+  std::size_t finishedLevels = 0;
+  std::size_t leafCount = 0;
+  bool error = false;
+};
+
+// rejects all children of the root node
+struct DirectChildrenLevelVisitor
+  : public Dune::TypeTree::DefaultLevelVisitor
+  , public Dune::TypeTree::VisitDirectChildren
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class Depth>
+  void beginLevel(Depth)
+  {
+    ++levels;
+  }
+
+  std::size_t levels = 0;
+};
+
+int main()
+{
+  Dune::TestSuite test("level traversal");
+
+  using Vector = Power<Leaf,2>;
+  using Tree = Composite<Vector,Leaf,DynamicPower<Vector>>;
+  Tree tree{Vector(Leaf(),Leaf()),
+            Leaf(),
+            DynamicPower<Vector>(Vector(Leaf(),Leaf()),Vector(Leaf(),Leaf()))};
+
+  using Levels = std::vector<std::vector<std::string>>;
+
+  {
+    LevelRecorder<Dune::TypeTree::DynamicTraversal> visitor;
+    Dune::TypeTree::applyToTreeByLevel(tree,visitor);
+    Levels expected = {
+      {"[ ]"},
+      {"[ 0 ]", "[ 1 ]", "[ 2 ]"},
+      {"[ 0 0 ]", "[ 0 1 ]", "[ 2 0 ]", "[ 2 1 ]"},
+      {"[ 2 0 0 ]", "[ 2 0 1 ]", "[ 2 1 0 ]", "[ 2 1 1 ]"}
+    };
+    test.check(visitor.levels == expected) << "Wrong level order for dynamic traversal";
+    test.check(visitor.finishedLevels == 4) << "Wrong number of level barriers";
+    test.check(visitor.leafCount == 7) << "Wrong number of leaves";
+    test.check(not visitor.error) << "Wrong depth passed to level callbacks";
+  }
+
+  {
+    // static traversal groups the children of static power nodes by index
+    LevelRecorder<Dune::TypeTree::StaticTraversal> visitor;
+    const Tree& constTree = tree;
+    Dune::TypeTree::applyToTreeByLevel(constTree,visitor);
+    Levels expected = {
+      {"[ ]"},
+      {"[ 0 ]", "[ 1 ]", "[ 2 ]"},
+      {"[ 0 0 ]", "[ 0 1 ]", "[ 2 0 ]", "[ 2 1 ]"},
+      {"[ 2 0 0 ]", "[ 2 1 0 ]", "[ 2 0 1 ]", "[ 2 1 1 ]"}
+    };
+    test.check(visitor.levels == expected) << "Wrong level order for static traversal";
+    test.check(not visitor.error) << "Wrong depth passed to level callbacks";
+  }
+
+  {
+    // the buffer can be reused across traversals and trees
+    using Visitor = LevelRecorder<Dune::TypeTree::DynamicTraversal>;
+    Dune::TypeTree::LevelTraversalBuffer<Tree,Visitor> buffer;
+    Visitor first;
+    Dune::TypeTree::applyToTreeByLevel(tree,first,buffer);
+
+    Tree other{Vector(Leaf(),Leaf()),
+               Leaf(),
+               DynamicPower<Vector>(Vector(Leaf(),Leaf()))};
+    Visitor second;
+    Dune::TypeTree::applyToTreeByLevel(other,second,buffer);
+    test.check(second.leafCount == 5) << "Reused buffer was not cleared";
+    test.check(second.levels.back().size() == 2) << "Reused buffer was not cleared";
+  }
+
+  {
+    DirectChildrenLevelVisitor visitor;
+    Dune::TypeTree::applyToTreeByLevel(tree,visitor);
+    test.check(visitor.levels == 1) << "Rejected children were visited";
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,110 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include <dune/common/classname.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/filteredcompositenode.hh>
+#include <dune/typetree/filters.hh>
+#include <dune/typetree/memoryfootprint.hh>
+#include <dune/typetree/proxynode.hh>
+#include <dune/typetree/uniquenodes.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+template<class T, std::size_t k>
+struct UniquePower : public Dune::TypeTree::UniquePowerNode<T,k>
+{
+  template<class... C>
+  UniquePower(C&&... c) : Dune::TypeTree::UniquePowerNode<T,k>(std::forward<C>(c)...) {}
+};
+
+template<class Node>
+struct Proxy : public Dune::TypeTree::ProxyNode<Node>
+{
+  Proxy(Node& node) : Dune::TypeTree::ProxyNode<Node>(node) {}
+};
+
+int main()
+{
+  Dune::TestSuite test("memory footprint");
+
+  using Vector = Power<Leaf,2>;
+  using Tree = Composite<Vector,DynamicPower<Leaf>>;
+
+  // the vector stores the same leaf twice
+  auto leaf = std::make_shared<Leaf>();
+  Tree tree(std::make_shared<Vector>(leaf,leaf),
+            std::make_shared<DynamicPower<Leaf>>(std::make_shared<Leaf>(),std::make_shared<Leaf>(),std::make_shared<Leaf>()));
+
+  {
+    auto footprint = Dune::TypeTree::memoryFootprint(tree);
+    test.check(footprint.nodes == 7) << "Wrong number of nodes: " << footprint.nodes;
+    test.check(footprint.controlBlocks == 6) << "Wrong number of control blocks: " << footprint.controlBlocks;
+    test.check(footprint.sharedNodes == 1) << "Wrong number of shared nodes: " << footprint.sharedNodes;
+    test.check(footprint.wrapperBytes == 0) << "Wrong wrapper size";
+
+    const auto& leaves = footprint.nodeTypes[Dune::className<Leaf>()];
+    test.check(leaves.count == 4) << "Wrong number of leaves: " << leaves.count;
+    test.check(footprint.nodeTypes[Dune::className<Vector>()].bytes == sizeof(Vector))
+      << "Wrong size of power node";
+
+    const auto& dynamic = tree.child(Dune::Indices::_1);
+    std::size_t dynamicBytes = sizeof(DynamicPower<Leaf>) + dynamic.nodeStorage().capacity() * sizeof(std::shared_ptr<Leaf>);
+    test.check(footprint.nodeTypes[Dune::className<DynamicPower<Leaf>>()].bytes == dynamicBytes)
+      << "Heap storage of dynamic power node is not included";
+
+    std::size_t bytes = 0;
+    for (const auto& [name, nodeType] : footprint.nodeTypes)
+      bytes += nodeType.bytes;
+    test.check(bytes == footprint.bytes) << "Total does not match the sum over node types";
+
+    std::ostringstream report;
+    footprint.report(report);
+    test.check(report.str().find("shared nodes: 1") != std::string::npos) << "Wrong report";
+  }
+
+  {
+    // the proxied tree is visited in place of the proxy
+    Proxy<const Tree> proxy(tree);
+    auto footprint = Dune::TypeTree::memoryFootprint(proxy);
+    test.check(footprint.nodes == 8) << "Wrong number of nodes with proxy: " << footprint.nodes;
+    test.check(footprint.wrapperBytes == sizeof(Proxy<const Tree>)) << "Wrong wrapper size of proxy";
+  }
+
+  {
+    // filtered children are still part of the footprint
+    Dune::TypeTree::FilteredCompositeNode<const Tree,Dune::TypeTree::IndexFilter<1>> filtered(tree);
+    auto footprint = Dune::TypeTree::memoryFootprint(filtered);
+    test.check(footprint.nodes == 8) << "Wrong number of nodes with filter: " << footprint.nodes;
+    test.check(footprint.wrapperBytes == sizeof(filtered)) << "Wrong wrapper size of filtered node";
+  }
+
+  {
+    // uniquely owned children do not have control blocks
+    UniquePower<Leaf,3> unique{Leaf(),Leaf(),Leaf()};
+    auto footprint = Dune::TypeTree::memoryFootprint(unique);
+    test.check(footprint.nodes == 4) << "Wrong number of unique nodes";
+    test.check(footprint.controlBlocks == 0) << "Unique nodes have control blocks";
+
+    // released children are skipped
+    auto released = unique.releaseChild(1);
+    test.check(Dune::TypeTree::memoryFootprint(unique).nodes == 3) << "Released child was counted";
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,136 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/memoryresource.hh>
+#include <dune/typetree/transformation.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+
+#include "typetreetestnodes.hh"
+
+// memory resource that counts the allocations forwarded to its upstream resource
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  explicit CountingResource(std::pmr::memory_resource* upstream)
+    : upstream_(upstream)
+  {}
+
+  std::size_t allocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return upstream_->allocate(bytes,alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    upstream_->deallocate(p,bytes,alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_;
+};
+
+struct Leaf : public Dune::TypeTree::LeafNode
+{
+  typedef Dune::TypeTree::LeafNodeTag ImplementationTag;
+};
+
+struct TransformedLeaf : public Dune::TypeTree::LeafNode {};
+
+struct PlainTransformation {};
+
+struct ArenaTransformation : public Dune::TypeTree::MemoryResourceTransformation
+{
+  using MemoryResourceTransformation::MemoryResourceTransformation;
+};
+
+template<class T, class Trafo>
+Dune::TypeTree::SimpleLeafNodeTransformation<T,Trafo,TransformedLeaf>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T, class Trafo>
+Dune::TypeTree::SimplePowerNodeTransformation<T,Trafo,Power>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T, class Trafo>
+Dune::TypeTree::SimpleDynamicPowerNodeTransformation<T,Trafo,DynamicPower>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::DynamicPowerNodeTag*);
+
+template<class T, class Trafo>
+Dune::TypeTree::SimpleCompositeNodeTransformation<T,Trafo,Composite>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::CompositeNodeTag*);
+
+int main()
+{
+  using namespace Dune::Indices;
+  using Dune::TypeTree::allocateNode;
+
+  Dune::TestSuite test("memory resource");
+
+  using Vector = Power<Leaf,2>;
+  using Tree = Composite<Vector,DynamicPower<Leaf>>;
+
+  CountingResource sourceResource(std::pmr::new_delete_resource());
+
+  // build the source tree with the node factory
+  auto tree = allocateNode<Tree>(&sourceResource,
+    allocateNode<Vector>(&sourceResource,allocateNode<Leaf>(&sourceResource),allocateNode<Leaf>(&sourceResource)),
+    allocateNode<DynamicPower<Leaf>>(&sourceResource,allocateNode<Leaf>(&sourceResource)));
+
+  // one allocation for each node including its control block
+  test.check(sourceResource.allocations == 6)
+    << "Wrong number of allocations in node factory: " << sourceResource.allocations;
+
+  {
+    std::pmr::monotonic_buffer_resource buffer(std::pmr::new_delete_resource());
+    CountingResource resource(&buffer);
+
+    using Transformation = Dune::TypeTree::TransformTree<Tree,ArenaTransformation>;
+    auto transformed = Transformation::transform_storage(tree,ArenaTransformation(&resource));
+
+    test.check(resource.allocations == 6)
+      << "Transformed nodes were not allocated from the memory resource: " << resource.allocations;
+    test.check(transformed->child(_1).degree() == 1)
+      << "Wrong degree of transformed dynamic power node";
+
+    // transform() only allocates the children from the resource
+    resource.allocations = 0;
+    Transformation::transformed_type root = Transformation::transform(*tree,ArenaTransformation(&resource));
+    test.check(root.child(_0).degree() == 2)
+      << "Wrong degree of transformed power node";
+    test.check(resource.allocations == 5)
+      << "Transformed children were not allocated from the memory resource: " << resource.allocations;
+  }
+
+  {
+    // transformations without a memory resource still use the global heap
+    using Transformation = Dune::TypeTree::TransformTree<Tree,PlainTransformation>;
+    auto transformed = Transformation::transform_storage(tree);
+    test.check(transformed->child(_0).degree() == 2)
+      << "Wrong degree of transformed power node";
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,130 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/packedtreepath.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+int main()
+{
+  using namespace Dune::Indices;
+  using Dune::TypeTree::hybridTreePath;
+
+  Dune::TestSuite test("packed tree path");
+
+  using Vector = Power<Leaf,3>;
+  using Tree = Composite<Vector,Leaf,DynamicPower<Vector>>;
+
+  Tree tree{Vector(Leaf(),Leaf(),Leaf()),
+            Leaf(),
+            DynamicPower<Vector>(Vector(Leaf(),Leaf(),Leaf()),Vector(Leaf(),Leaf(),Leaf()),
+                                 Vector(Leaf(),Leaf(),Leaf()),Vector(Leaf(),Leaf(),Leaf()),
+                                 Vector(Leaf(),Leaf(),Leaf()))};
+
+  Dune::TypeTree::PackedTreePathLayout layout(tree);
+  using Path = Dune::TypeTree::PackedTreePath<>;
+
+  test.check(layout.depth() == 3) << "Wrong depth of layout";
+  test.check(layout.width(0) == 2) << "Wrong width of level 0";
+  test.check(layout.width(1) == 3) << "Wrong width of level 1";
+  test.check(layout.width(2) == 2) << "Wrong width of level 2";
+
+  // all nodes have distinct paths, ordered like the traversal
+  std::vector<Path> paths;
+  std::unordered_map<Path,int> cache;
+  Dune::TypeTree::forEachNode(tree, [&](auto&& node, auto tp) {
+    Path path = layout.pack(tp);
+    test.check(path.size() == tp.size()) << "Wrong size of packed path";
+    test.check(layout.unpack<decltype(tp)>(path) == tp)
+      << "Round trip failed for path " << tp;
+    paths.push_back(path);
+    cache[path] = paths.size();
+  });
+  test.check(paths.size() == 27) << "Wrong number of nodes";
+  test.check(cache.size() == paths.size()) << "Packed paths are not unique";
+  for (std::size_t i = 1; i < paths.size(); ++i)
+    test.check(paths[i-1] < paths[i]) << "Packed paths are not ordered like the traversal";
+
+  {
+    auto tp = hybridTreePath(_2,4,_1);
+    Path path = layout.pack(tp);
+    test.check(layout.entry(path,1) == 4) << "Wrong entry";
+    test.check(path == layout.push_back(layout.push_back(layout.pack(hybridTreePath(_2)),4),1))
+      << "push_back() does not match pack()";
+    test.check(std::hash<Path>{}(path) == std::hash<Path>{}(layout.pack(hybridTreePath(2,4,1))))
+      << "Equal paths have different hashes";
+
+    test.check(isPrefix(layout.pack(hybridTreePath(_2,4)),path)) << "Wrong prefix test";
+    test.check(isPrefix(Path(),path)) << "Root path is not a prefix";
+    test.check(isPrefix(path,path)) << "Path is not a prefix of itself";
+    test.check(not isPrefix(layout.pack(hybridTreePath(_2,3)),path)) << "Wrong prefix test";
+    test.check(not isPrefix(path,layout.pack(hybridTreePath(_2,4)))) << "Wrong prefix test";
+  }
+
+  {
+    // entries that exceed the width of the layout are detected
+    bool thrown = false;
+    try {
+      layout.pack(hybridTreePath(2,8));
+    }
+    catch (const Dune::RangeError&) {
+      thrown = true;
+    }
+    test.check(thrown) << "Index exceeding the layout was not detected";
+
+    thrown = false;
+    try {
+      layout.pack(hybridTreePath(2,0,0,0));
+    }
+    catch (const Dune::RangeError&) {
+      thrown = true;
+    }
+    test.check(thrown) << "Path exceeding the layout depth was not detected";
+  }
+
+  {
+    // bit fields do not span two words
+    Dune::TypeTree::PackedTreePathLayout deepLayout(std::vector<std::size_t>(30,6));
+    test.check(deepLayout.bits(21) == 63) << "Wrong number of bits";
+    test.check(deepLayout.bits(22) == 64 + 3) << "Bit field spans two words";
+    Dune::TypeTree::PackedTreePath<1> narrow;
+    for (std::size_t i = 0; i < 21; ++i)
+      narrow = deepLayout.push_back(narrow,5);
+    bool thrown = false;
+    try {
+      deepLayout.push_back(narrow,5);
+    }
+    catch (const Dune::RangeError&) {
+      thrown = true;
+    }
+    test.check(thrown) << "Path exceeding the capacity was not detected";
+
+    Path wide;
+    for (std::size_t i = 0; i < 30; ++i)
+      wide = deepLayout.push_back(wide,i % 6);
+    for (std::size_t i = 0; i < 30; ++i)
+      test.check(deepLayout.entry(wide,i) == i % 6) << "Wrong entry in second word";
+  }
+
+  return test.exit();
+}
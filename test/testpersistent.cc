@@ -0,0 +1,64 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <memory>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/persistent.hh>
+#include <dune/typetree/treepath.hh>
+
+#include "typetreetestnodes.hh"
+
+int main()
+{
+  using namespace Dune::Indices;
+  using Dune::TypeTree::treePath;
+
+  Dune::TestSuite test("persistent trees");
+
+  using Vector = Power<ValueLeaf,2>;
+  using Tree = Composite<Vector,ValueLeaf,DynamicPower<Vector>>;
+  auto tree = std::make_shared<const Tree>(Vector(ValueLeaf(1),ValueLeaf(2)),
+                                           ValueLeaf(3),
+                                           DynamicPower<Vector>(Vector(ValueLeaf(4),ValueLeaf(5)),Vector(ValueLeaf(6),ValueLeaf(7))));
+
+  {
+    auto updated = Dune::TypeTree::withChild(*tree,treePath(_0,1),ValueLeaf(8));
+    test.check(updated->child(_0,1).value == 8) << "Child was not replaced";
+    test.check(tree->child(_0,1).value == 2) << "Original tree was modified";
+
+    // only the nodes on the path are copied
+    test.check(&updated->child(_0) != &tree->child(_0)) << "Node on the path was not copied";
+    test.check(&updated->child(_0,0) == &tree->child(_0,0)) << "Sibling was not shared";
+    test.check(&updated->child(_1) == &tree->child(_1)) << "Unchanged subtree was not shared";
+    test.check(&updated->child(_2) == &tree->child(_2)) << "Unchanged subtree was not shared";
+  }
+
+  {
+    // dynamic indices and a new child given by its storage
+    auto vector = std::make_shared<Vector>(ValueLeaf(9),ValueLeaf(10));
+    auto updated = Dune::TypeTree::withChild(*tree,treePath(_2,std::size_t(1)),vector);
+    test.check(&updated->child(_2,1) == vector.get()) << "Child storage was not used";
+    test.check(&updated->child(_2,0) == &tree->child(_2,0)) << "Sibling was not shared";
+    test.check(tree->child(_2,1,0).value == 6) << "Original tree was modified";
+
+    // updates can be chained, each one sharing the unchanged parts with its predecessor
+    auto second = Dune::TypeTree::withChild(*updated,treePath(_2,std::size_t(0),_1),ValueLeaf(11));
+    test.check(second->child(_2,0,1).value == 11) << "Child was not replaced";
+    test.check(updated->child(_2,0,1).value == 5) << "Previous version was modified";
+    test.check(&second->child(_2,1) == vector.get()) << "Unchanged subtree was not shared";
+    test.check(&second->child(_0) == &tree->child(_0)) << "Unchanged subtree was not shared";
+  }
+
+  return test.exit();
+}
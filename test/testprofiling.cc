@@ -0,0 +1,163 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/accumulate_static.hh>
+#include <dune/typetree/pairtraversal.hh>
+#include <dune/typetree/profiling.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+#include <dune/typetree/transformation.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode
+{
+  typedef Dune::TypeTree::LeafNodeTag ImplementationTag;
+};
+
+struct TransformedLeaf : public Dune::TypeTree::LeafNode {};
+
+struct TimedTransformation : public Dune::TypeTree::ProfilingTransformation
+{
+  using ProfilingTransformation::ProfilingTransformation;
+};
+
+template<class T, class Trafo>
+Dune::TypeTree::SimpleLeafNodeTransformation<T,Trafo,TransformedLeaf>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T, class Trafo>
+Dune::TypeTree::SimplePowerNodeTransformation<T,Trafo,Power>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T, class Trafo>
+Dune::TypeTree::SimpleCompositeNodeTransformation<T,Trafo,Composite>
+registerNodeTransformation(T*, Trafo*, Dune::TypeTree::CompositeNodeTag*);
+
+struct LeafCounter
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class T, class TreePath>
+  void leaf(T&&, TreePath)
+  {
+    ++leaves;
+  }
+
+  std::size_t leaves = 0;
+};
+
+struct PairLeafCounter
+  : public Dune::TypeTree::TreePairVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class T1, class T2, class TreePath>
+  void leaf(T1&&, T2&&, TreePath)
+  {
+    ++leaves;
+  }
+
+  std::size_t leaves = 0;
+};
+
+// sums the number of calls of a callback over all node types and tree paths
+std::size_t calls(const Dune::TypeTree::Profiler& profiler, Dune::TypeTree::ProfilingCallback callback)
+{
+  std::size_t count = 0;
+  for (const auto& [key, statistics] : profiler.statistics())
+    if (key.callback == callback)
+      count += statistics.count;
+  return count;
+}
+
+int main()
+{
+  using namespace Dune::Indices;
+  using Callback = Dune::TypeTree::ProfilingCallback;
+
+  Dune::TestSuite test("profiling");
+
+  using Vector = Power<Leaf,2>;
+  using Tree = Composite<Vector,Leaf>;
+  Tree tree{Vector(Leaf(),Leaf()),Leaf()};
+
+  {
+    Dune::TypeTree::Profiler profiler(true);
+    LeafCounter counter;
+    Dune::TypeTree::applyToTree(tree,Dune::TypeTree::profile(counter,profiler));
+    test.check(counter.leaves == 3) << "Callbacks were not forwarded";
+    test.check(calls(profiler,Callback::leaf) == 3) << "Wrong number of leaf calls";
+    test.check(calls(profiler,Callback::pre) == 2) << "Wrong number of pre calls";
+    test.check(calls(profiler,Callback::subtree) == 2) << "Wrong number of subtree spans";
+    test.check(calls(profiler,Callback::beforeChild) == 4) << "Wrong number of beforeChild calls";
+
+    // each leaf has its own tree path
+    std::size_t leafKeys = 0;
+    for (const auto& [key, statistics] : profiler.statistics())
+      if (key.callback == Callback::leaf) {
+        ++leafKeys;
+        test.check(key.nodeType().find("Leaf") != std::string::npos) << "Wrong node type " << key.nodeType();
+        test.check(key.treePath().starts_with("[ ")) << "Wrong tree path " << key.treePath();
+      }
+    test.check(leafKeys == 3) << "Calls were not distinguished by tree path";
+
+    std::ostringstream report;
+    profiler.report(report);
+    test.check(report.str().find("leaf") != std::string::npos) << "Report does not contain leaf calls";
+
+    std::ostringstream trace;
+    profiler.writeChromeTrace(trace);
+    const std::string json = trace.str();
+    test.check(json.find("\"traceEvents\"") != std::string::npos) << "Trace is not in Chrome trace format";
+    std::size_t events = 0;
+    for (std::size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos; pos = json.find("\"ph\":\"X\"",pos+1))
+      ++events;
+    test.check(events == 19) << "Wrong number of trace events: " << events;
+  }
+
+  {
+    Dune::TypeTree::Profiler profiler;
+    PairLeafCounter counter;
+    Dune::TypeTree::applyToTreePair(tree,tree,Dune::TypeTree::profile(counter,profiler));
+    test.check(counter.leaves == 3) << "Pair callbacks were not forwarded";
+    test.check(calls(profiler,Callback::leaf) == 3) << "Wrong number of pair leaf calls";
+  }
+
+  {
+    Dune::TypeTree::Profiler profiler;
+    auto visitor = Dune::TypeTree::profile(Dune::TypeTree::Experimental::Info::LeafCounterVisitor{},profiler);
+    auto leaves = Dune::TypeTree::Experimental::hybridApplyToTree(tree,visitor,_0);
+    test.check(leaves == 3) << "Hybrid visitor results were not forwarded";
+    test.check(calls(profiler,Callback::leaf) == 3) << "Wrong number of hybrid leaf calls";
+  }
+
+  {
+    Dune::TypeTree::Profiler profiler;
+    using Transformation = Dune::TypeTree::TransformTree<Tree,TimedTransformation>;
+    auto transformed = Transformation::transform(tree,TimedTransformation(&profiler));
+    test.check(transformed.child(_0).degree() == 2) << "Wrong transformed tree";
+    test.check(calls(profiler,Callback::transform) + calls(profiler,Callback::transform_storage) == 5)
+      << "Node transformations were not timed";
+
+    // transformations without a profiler are not timed
+    Transformation::transform(tree,TimedTransformation());
+  }
+
+  return test.exit();
+}
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
 #include "config.h"
 
+#include <type_traits>
+
 #include <dune/common/classname.hh>
 #include <dune/common/test/testsuite.hh>
 
@@ -45,6 +47,10 @@ void testProxyNode(Node& node)
   static_assert(decltype(Info::depth(node)){} == decltype(Info::depth(proxyNode)){}, "Proxy node has wrong depth");
   suite.check(Info::nodeCount(node) == Info::nodeCount(proxyNode)) << "Proxy node has wrong node count";
   suite.check(Info::leafCount(node) == Info::leafCount(proxyNode)) << "Proxy node has wrong leaf count";
+
+  if constexpr (not Node::isLeaf and not std::is_const_v<Node>)
+    suite.check(&proxyNode.childStorageRef(Dune::Indices::_0) == &node.childStorageRef(Dune::Indices::_0))
+      << "Proxy node does not forward the child storage";
 }
 
 
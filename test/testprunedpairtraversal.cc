@@ -0,0 +1,102 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/pairtraversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+template<class TreePath>
+std::string toString(TreePath tp)
+{
+  std::ostringstream s;
+  s << "[";
+  for (std::size_t i = 0; i < tp.size(); ++i)
+    s << " " << tp[i];
+  s << " ]";
+  return s.str();
+}
+
+// records the visited leaves and the skipped subtrees
+template<class... Mixins>
+struct DiffVisitor
+  : public Dune::TypeTree::TreePairVisitor
+  , public Dune::TypeTree::DynamicTraversal
+  , public Mixins...
+{
+  template<class T1, class T2, class TreePath>
+  void leaf(T1&&, T2&&, TreePath tp)
+  {
+    leaves.push_back(toString(tp));
+  }
+
+  template<class T1, class T2, class TreePath>
+  void identical(T1&&, T2&&, TreePath tp)
+  {
+    shared.push_back(toString(tp));
+  }
+
+  std::vector<std::string> leaves;
+  std::vector<std::string> shared;
+};
+
+int main()
+{
+  Dune::TestSuite test("pruned pair traversal");
+
+  using Vector = Power<Leaf,2>;
+  using Tree = Composite<Vector,Vector,Leaf>;
+
+  auto a = std::make_shared<Vector>(Leaf(),Leaf());
+  auto b = std::make_shared<Vector>(Leaf(),Leaf());
+  auto c = std::make_shared<Vector>(Leaf(),Leaf());
+  auto leaf = std::make_shared<Leaf>();
+
+  // the second version of the tree only replaces the second child
+  Tree tree1(a,b,leaf);
+  Tree tree2(a,c,leaf);
+
+  {
+    DiffVisitor<Dune::TypeTree::PruneIdenticalSubtrees> visitor;
+    Dune::TypeTree::applyToTreePair(tree1,tree2,visitor);
+    test.check(visitor.leaves == std::vector<std::string>{"[ 1 0 ]","[ 1 1 ]"})
+      << "Wrong leaves visited for trees with shared subtrees";
+    test.check(visitor.shared == std::vector<std::string>{"[ 0 ]","[ 2 ]"})
+      << "Shared subtrees were not detected";
+  }
+
+  {
+    // identical roots are not traversed at all
+    DiffVisitor<Dune::TypeTree::PruneIdenticalSubtrees> visitor;
+    const Tree& constTree = tree1;
+    Dune::TypeTree::applyToTreePair(tree1,constTree,visitor);
+    test.check(visitor.leaves.empty()) << "Identical trees were traversed";
+    test.check(visitor.shared == std::vector<std::string>{"[ ]"}) << "Identical root was not detected";
+  }
+
+  {
+    // without the mixin, the trees are traversed completely
+    DiffVisitor<> visitor;
+    Dune::TypeTree::applyToTreePair(tree1,tree2,visitor);
+    test.check(visitor.leaves.size() == 5) << "Wrong number of leaves without pruning";
+    test.check(visitor.shared.empty()) << "Subtrees were pruned without PruneIdenticalSubtrees";
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/recursivefilter.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+using VelocityLeaf = ValueLeaf;
+
+// a distinct leaf type for the filters
+struct PressureLeaf : public ValueLeaf
+{
+  using ValueLeaf::ValueLeaf;
+};
+
+using Velocity = Power<VelocityLeaf,2>;
+using Mixed = Composite<VelocityLeaf,PressureLeaf>;
+using MixedVector = DynamicPower<Mixed>;
+using Tree = Composite<Velocity,PressureLeaf,MixedVector>;
+
+struct SelectVelocity
+{
+  template<class Leaf, class TreePath>
+  auto operator()(const Leaf&, TreePath) const
+  {
+    return std::bool_constant<std::is_same_v<Leaf,VelocityLeaf>>{};
+  }
+};
+
+struct SelectPressure
+{
+  template<class Leaf, class TreePath>
+  auto operator()(const Leaf&, TreePath) const
+  {
+    return std::bool_constant<std::is_same_v<Leaf,PressureLeaf>>{};
+  }
+};
+
+struct LeafSum
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class Leaf, class TreePath>
+  void leaf(const Leaf& leaf, TreePath)
+  {
+    sum += leaf.value;
+    ++count;
+  }
+
+  int sum = 0;
+  int count = 0;
+};
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("recursive filter");
+
+  Tree tree(Velocity(VelocityLeaf(1),VelocityLeaf(2)),
+            PressureLeaf(10),
+            MixedVector(Mixed(VelocityLeaf(3),PressureLeaf(20)),
+                        Mixed(VelocityLeaf(4),PressureLeaf(30)),
+                        Mixed(VelocityLeaf(5),PressureLeaf(40))));
+
+  {
+    auto view = Dune::TypeTree::filterTree(tree,SelectVelocity{});
+    using View = decltype(view);
+
+    // the pressure leaf is removed at compile time
+    static_assert(View::degree() == 2);
+    static_assert(View::Child<0>::original_index == 0);
+    static_assert(View::Child<1>::original_index == 2);
+    static_assert(View::Child<1>::Type::ChildType::degree() == 1);
+
+    test.check(&view.child(_0).child(_1) == &tree.child(_0).child(_1))
+      << "Filtered view does not reference the original leaf";
+    test.check(view.child(_1).degree() == 3)
+      << "Wrong degree of filtered dynamic power node";
+    test.check(view.child(_1).child(2).child(_0).value == 5)
+      << "Wrong leaf in filtered dynamic power node";
+
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(view,visitor);
+    test.check(visitor.count == 5) << "Wrong number of leaves in filtered tree";
+    test.check(visitor.sum == 15) << "Wrong leaves in filtered tree";
+  }
+
+  {
+    const Tree& constTree = tree;
+    auto view = Dune::TypeTree::filterTree(constTree,SelectPressure{});
+    using View = decltype(view);
+
+    static_assert(View::degree() == 2);
+    static_assert(View::Child<0>::original_index == 1);
+
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(view,visitor);
+    test.check(visitor.count == 4) << "Wrong number of leaves in filtered tree";
+    test.check(visitor.sum == 100) << "Wrong leaves in filtered tree";
+  }
+
+  {
+    // runtime predicate on the children of a dynamic power node
+    using VelocityVector = DynamicPower<VelocityLeaf>;
+    using RuntimeTree = Composite<VelocityVector,PressureLeaf>;
+    RuntimeTree runtimeTree(VelocityVector(VelocityLeaf(1),VelocityLeaf(2),VelocityLeaf(3),VelocityLeaf(4)),
+                            PressureLeaf(10));
+
+    auto predicate = [](const auto& leaf, auto treePath) {
+      if constexpr (std::is_same_v<std::decay_t<decltype(leaf)>,VelocityLeaf>)
+        return treePath[_1] % 2 == 1;
+      else
+        return std::false_type{};
+    };
+
+    auto view = Dune::TypeTree::filterTree(runtimeTree,predicate);
+    static_assert(decltype(view)::degree() == 1);
+
+    test.check(view.child(_0).degree() == 2)
+      << "Wrong degree of filtered dynamic power node";
+    test.check(view.child(_0).originalIndex(1) == 3)
+      << "Wrong index map of filtered dynamic power node";
+    test.check(view.child(_0).child(1).value == 4)
+      << "Wrong leaf in filtered dynamic power node";
+
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(view,visitor);
+    test.check(visitor.sum == 6) << "Wrong leaves in filtered tree";
+  }
+
+  return test.exit();
+}
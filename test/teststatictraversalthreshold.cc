@@ -0,0 +1,160 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/accumulate_static.hh>
+#include <dune/typetree/leveltraversal.hh>
+#include <dune/typetree/pairtraversal.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+struct Leaf : public Dune::TypeTree::LeafNode {};
+
+// encodes the kind of each tree path entry, 's' for static and 'd' for dynamic
+template<class... T>
+std::string entryKinds(const Dune::TypeTree::HybridTreePath<T...>&)
+{
+  return std::string{(Dune::IsIntegralConstant<T>::value ? 's' : 'd')...};
+}
+
+// counts the leaves by the kinds of their tree path entries
+template<class... Mixins>
+struct KindVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Mixins...
+{
+  template<class T, class TreePath>
+  void leaf(T&&, TreePath tp)
+  {
+    ++kinds[entryKinds(tp)];
+  }
+
+  std::map<std::string,std::size_t> kinds;
+};
+
+struct KindPairVisitor
+  : public Dune::TypeTree::TreePairVisitor
+  , public Dune::TypeTree::StaticTraversal
+  , public Dune::TypeTree::StaticTraversalThreshold<4>
+{
+  template<class T1, class T2, class TreePath>
+  void leaf(T1&&, T2&&, TreePath tp)
+  {
+    ++kinds[entryKinds(tp)];
+  }
+
+  std::map<std::string,std::size_t> kinds;
+};
+
+struct KindLevelVisitor
+  : public Dune::TypeTree::TreeLevelVisitor
+  , public Dune::TypeTree::StaticTraversal
+  , public Dune::TypeTree::StaticTraversalThreshold<4>
+{
+  template<class T, class TreePath>
+  void leaf(T&&, TreePath tp)
+  {
+    ++kinds[entryKinds(tp)];
+  }
+
+  std::map<std::string,std::size_t> kinds;
+};
+
+struct KindHybridVisitor
+  : public Dune::TypeTree::Experimental::DefaultHybridVisitor
+  , public Dune::TypeTree::VisitTree
+  , public Dune::TypeTree::StaticTraversal
+  , public Dune::TypeTree::StaticTraversalThreshold<4>
+{
+  template<class T, class TreePath>
+  std::size_t leaf(T&&, TreePath tp, std::size_t count)
+  {
+    return count + (entryKinds(tp) == "sd" ? 1 : 0);
+  }
+};
+
+int main()
+{
+  Dune::TestSuite test("static traversal threshold");
+
+  using Small = Power<Leaf,2>;
+  using Large = Power<Leaf,6>;
+  using Tree = Composite<Small,Large>;
+  Tree tree{Small(Leaf(),Leaf()),
+            Large(Leaf(),Leaf(),Leaf(),Leaf(),Leaf(),Leaf())};
+
+  using Kinds = std::map<std::string,std::size_t>;
+
+  {
+    KindVisitor<Dune::TypeTree::StaticTraversal> visitor;
+    Dune::TypeTree::applyToTree(tree,visitor);
+    test.check(visitor.kinds == Kinds{{"ss",8}}) << "Static traversal without threshold is not static";
+  }
+
+  {
+    // only the children of the large power node are traversed with a run-time loop
+    KindVisitor<Dune::TypeTree::StaticTraversal,Dune::TypeTree::StaticTraversalThreshold<4>> visitor;
+    Dune::TypeTree::applyToTree(tree,visitor);
+    test.check(visitor.kinds == (Kinds{{"ss",2},{"sd",6}})) << "Wrong tree paths for static traversal with threshold";
+  }
+
+  {
+    KindVisitor<Dune::TypeTree::StaticTraversal,Dune::TypeTree::StaticTraversalThreshold<6>> visitor;
+    Dune::TypeTree::applyToTree(tree,visitor);
+    test.check(visitor.kinds == Kinds{{"ss",8}}) << "Threshold is not inclusive";
+  }
+
+  {
+    // the fused visitor uses the smallest threshold
+    KindVisitor<Dune::TypeTree::StaticTraversal> first;
+    KindVisitor<Dune::TypeTree::StaticTraversal,Dune::TypeTree::StaticTraversalThreshold<4>> second;
+    Dune::TypeTree::applyToTree(tree,Dune::TypeTree::fuse(first,second));
+    test.check(first.kinds == (Kinds{{"ss",2},{"sd",6}})) << "Wrong threshold for fused visitor";
+  }
+
+  {
+    KindPairVisitor visitor;
+    Dune::TypeTree::applyToTreePair(tree,tree,visitor);
+    test.check(visitor.kinds == (Kinds{{"ss",2},{"sd",6}})) << "Wrong tree paths for pair traversal with threshold";
+  }
+
+  {
+    // a dynamic power node paired with a static one is traversed with a run-time loop in both orders
+    DynamicPower<Leaf> dynamic{Leaf(),Leaf()};
+    KindPairVisitor first;
+    Dune::TypeTree::applyToTreePair(tree.child(Dune::Indices::_0),dynamic,first);
+    test.check(first.kinds == Kinds{{"d",2}}) << "Wrong tree paths for pair traversal with dynamic second tree";
+    KindPairVisitor second;
+    Dune::TypeTree::applyToTreePair(dynamic,tree.child(Dune::Indices::_0),second);
+    test.check(second.kinds == Kinds{{"d",2}}) << "Wrong tree paths for pair traversal with dynamic first tree";
+  }
+
+  {
+    KindLevelVisitor visitor;
+    Dune::TypeTree::applyToTreeByLevel(tree,visitor);
+    test.check(visitor.kinds == (Kinds{{"ss",2},{"sd",6}})) << "Wrong tree paths for level traversal with threshold";
+  }
+
+  {
+    auto count = Dune::TypeTree::Experimental::hybridApplyToTree(tree,KindHybridVisitor{},std::size_t(0));
+    test.check(count == 6) << "Wrong tree paths for hybrid traversal with threshold";
+  }
+
+  return test.exit();
+}
@@ -0,0 +1,143 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/traversalplan.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+// logs all callbacks with their arguments
+struct LogVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class T, class TreePath>
+  void pre(T&& t, TreePath treePath) { log << "pre" << treePath; }
+
+  template<class T, class TreePath>
+  void in(T&& t, TreePath treePath) { log << "in" << treePath; }
+
+  template<class T, class TreePath>
+  void post(T&& t, TreePath treePath) { log << "post" << treePath; }
+
+  template<class T, class TreePath>
+  void leaf(T&& t, TreePath treePath) { log << "leaf" << treePath << t.value; }
+
+  template<class T, class Child, class TreePath, class ChildIndex>
+  void beforeChild(T&& t, Child&& child, TreePath treePath, ChildIndex i)
+  {
+    log << "before" << treePath << i << (&child == &t.child(i));
+  }
+
+  template<class T, class Child, class TreePath, class ChildIndex>
+  void afterChild(T&& t, Child&& child, TreePath treePath, ChildIndex i)
+  {
+    log << "after" << treePath << i;
+  }
+
+  std::ostringstream log;
+};
+
+// logs the leaves only and inherits the other callbacks
+struct LeafLogVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class T, class TreePath>
+  void leaf(T&& t, TreePath treePath) { log << "leaf" << treePath << t.value; }
+
+  std::ostringstream log;
+};
+
+template<class Tree>
+std::string directLog(Tree& tree)
+{
+  LogVisitor visitor;
+  Dune::TypeTree::applyToTree(tree,visitor);
+  return visitor.log.str();
+}
+
+template<class Plan, class Tree>
+std::string plannedLog(Plan& plan, Tree& tree)
+{
+  LogVisitor visitor;
+  plan.apply(tree,visitor);
+  return visitor.log.str();
+}
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("traversal plan");
+
+  using Tree = Composite<Power<ValueLeaf,2>,DynamicPower<ValueLeaf>>;
+  Tree tree{Power<ValueLeaf,2>(ValueLeaf(1),ValueLeaf(2)),DynamicPower<ValueLeaf>(ValueLeaf(3),ValueLeaf(4),ValueLeaf(5))};
+
+  Dune::TypeTree::TraversalPlan<Tree,LogVisitor> plan;
+  test.check(not plan.valid(tree)) << "Empty plan is valid";
+  test.check(plannedLog(plan,tree) == directLog(tree)) << "Replay differs from applyToTree()";
+  test.check(plan.valid(tree)) << "Plan was not recorded";
+  test.check(plan.steps().front().callback == Dune::TypeTree::TraversalCallback::pre) << "Wrong first step";
+
+  // the plan refers to the nodes, so changes of the data are visible in the replay
+  tree.child(_1).child(2).value = 6;
+  test.check(plannedLog(plan,tree) == directLog(tree)) << "Replay does not see data changes";
+
+  // replacing a child is detected by valid(), but apply() requires an explicit invalidate()
+  tree.child(_1).setChild(0,std::make_shared<ValueLeaf>(7));
+  test.check(not plan.valid(tree)) << "Plan is valid after setChild()";
+  plan.invalidate();
+  test.check(plannedLog(plan,tree) == directLog(tree)) << "Replay differs after setChild()";
+  test.check(plan.valid(tree)) << "Plan was not recorded again";
+
+  // a plan for another tree is recorded again
+  Tree other = tree;
+  test.check(not plan.valid(other)) << "Plan is valid for another tree";
+
+  // changing the structure of an unrelated tree does not affect the plan
+  Tree unrelated{Power<ValueLeaf,2>(ValueLeaf(1),ValueLeaf(2)),DynamicPower<ValueLeaf>(ValueLeaf(3))};
+  unrelated.child(_1).setChild(0,std::make_shared<ValueLeaf>(8));
+  test.check(plan.valid(tree)) << "Plan is invalidated by a change of another tree";
+
+  // assigning to an inner node with a dynamic degree is detected as well
+  tree.child(_1) = DynamicPower<ValueLeaf>(ValueLeaf(9));
+  test.check(not plan.valid(tree)) << "Plan is valid after assigning an inner node";
+  plan.invalidate();
+  test.check(not plan.valid(tree)) << "Plan is valid after invalidate()";
+  test.check(plannedLog(plan,tree) == directLog(tree)) << "Replay differs after assigning an inner node";
+
+  // callbacks inherited from DefaultVisitor are not recorded
+  {
+    Dune::TypeTree::TraversalPlan<Tree,LeafLogVisitor> leafPlan(tree);
+    test.check(leafPlan.steps().size() == 3) << "Inherited callbacks were recorded";
+    LeafLogVisitor planned, direct;
+    leafPlan.apply(tree,planned);
+    Dune::TypeTree::applyToTree(tree,direct);
+    test.check(planned.log.str() == direct.log.str()) << "Replay differs for a visitor with inherited callbacks";
+  }
+
+  // const trees are supported as well
+  const Tree& constTree = tree;
+  Dune::TypeTree::TraversalPlan<const Tree,LogVisitor> constPlan(constTree);
+  test.check(plannedLog(constPlan,constTree) == directLog(constTree)) << "Replay differs for const tree";
+
+  return test.exit();
+}
@@ -54,6 +54,10 @@ void check(const Tree& tree)
   std::cout << "==================================" << std::endl;
 }
 
+// the storage reference grants mutable access to the child, so const nodes do not provide it
+template<class Node>
+constexpr bool hasChildStorageRef = requires(Node& node) { node.childStorageRef(Dune::Indices::_0); };
+
 
 int main(int argc, char** argv)
 {
@@ -149,6 +153,15 @@ int main(int argc, char** argv)
   auto x6 = child(sc1_1, _0, _0);
 #endif
 
+  // storage access along a path
+  assert(childStorage(sc1_1, _1, _2).get() == &child(sc1_1, _1, _2));
+  assert(&childStorageRef(sc1_1, _1, _2) == &sc1_1.child(_1).childStorageRef(_2));
+  assert(childStorageRef(sdp_1, 1, _1, _0).get() == &child(sdp_1, 1, _1, _0));
+  assert(childStorageRef(sdp_1, Dune::TypeTree::hybridTreePath(1, _1, 2)) == sdp_1.child(1).child(_1).childStorage(2));
+  static_assert(hasChildStorageRef<SC1> and not hasChildStorageRef<const SC1>);
+  static_assert(hasChildStorageRef<SP1> and not hasChildStorageRef<const SP1>);
+  static_assert(hasChildStorageRef<SDP1> and not hasChildStorageRef<const SDP1>);
+
   return 0;
 }
 
@@ -0,0 +1,218 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/indices.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/powernode.hh>
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/uniquenodes.hh>
+#include <dune/typetree/transformation.hh>
+#include <dune/typetree/simpletransformationdescriptors.hh>
+#include <dune/typetree/generictransformationdescriptors.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+template<class T, std::size_t k>
+struct UniquePower : public Dune::TypeTree::UniquePowerNode<T,k>
+{
+  typedef Dune::TypeTree::PowerNodeTag ImplementationTag;
+
+  template<class... C>
+  UniquePower(C&&... c) : Dune::TypeTree::UniquePowerNode<T,k>(std::forward<C>(c)...) {}
+};
+
+template<class T>
+struct UniqueDynamicPower : public Dune::TypeTree::UniqueDynamicPowerNode<T>
+{
+  typedef Dune::TypeTree::DynamicPowerNodeTag ImplementationTag;
+
+  template<class... C>
+  UniqueDynamicPower(C&&... c) : Dune::TypeTree::UniqueDynamicPowerNode<T>(std::forward<C>(c)...) {}
+};
+
+template<class... T>
+struct UniqueComposite : public Dune::TypeTree::UniqueCompositeNode<T...>
+{
+  typedef Dune::TypeTree::CompositeNodeTag ImplementationTag;
+
+  template<class... C>
+  UniqueComposite(C&&... c) : Dune::TypeTree::UniqueCompositeNode<T...>(std::forward<C>(c)...) {}
+};
+
+struct LeafSum
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class Leaf, class TreePath>
+  void leaf(const Leaf& leaf, TreePath)
+  {
+    sum += leaf.value;
+    ++count;
+  }
+
+  int sum = 0;
+  int count = 0;
+};
+
+// transformation from shared to unique ownership
+struct ToUnique {};
+
+struct TransformedLeaf : public Dune::TypeTree::LeafNode
+{
+  int value = 1;
+};
+
+template<class T>
+Dune::TypeTree::SimpleUniqueLeafNodeTransformation<T,ToUnique,TransformedLeaf>
+registerNodeTransformation(T*, ToUnique*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleUniquePowerNodeTransformation<T,ToUnique,UniquePower>
+registerNodeTransformation(T*, ToUnique*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleUniqueDynamicPowerNodeTransformation<T,ToUnique,UniqueDynamicPower>
+registerNodeTransformation(T*, ToUnique*, Dune::TypeTree::DynamicPowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleUniqueCompositeNodeTransformation<T,ToUnique,UniqueComposite>
+registerNodeTransformation(T*, ToUnique*, Dune::TypeTree::CompositeNodeTag*);
+
+// transformation from unique to shared ownership with a descriptor that retains the source storage
+struct FromUnique {};
+
+struct RetainingLeaf : public Dune::TypeTree::LeafNode
+{
+  RetainingLeaf(std::shared_ptr<const ValueLeaf> s, const FromUnique&) : source(s), value(s->value) {}
+  RetainingLeaf(const ValueLeaf& s, const FromUnique&) : value(s.value) {}
+
+  std::shared_ptr<const ValueLeaf> source;
+  int value;
+};
+
+template<class T>
+Dune::TypeTree::GenericLeafNodeTransformation<T,FromUnique,RetainingLeaf>
+registerNodeTransformation(T*, FromUnique*, Dune::TypeTree::LeafNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimplePowerNodeTransformation<T,FromUnique,Power>
+registerNodeTransformation(T*, FromUnique*, Dune::TypeTree::PowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleDynamicPowerNodeTransformation<T,FromUnique,DynamicPower>
+registerNodeTransformation(T*, FromUnique*, Dune::TypeTree::DynamicPowerNodeTag*);
+
+template<class T>
+Dune::TypeTree::SimpleCompositeNodeTransformation<T,FromUnique,Composite>
+registerNodeTransformation(T*, FromUnique*, Dune::TypeTree::CompositeNodeTag*);
+
+// unique nodes do not hand out shared storage that could outlive them
+template<class Node>
+constexpr bool hasChildStorage = requires(Node& node) { node.childStorage(Dune::Indices::_0); };
+
+static_assert(not hasChildStorage<UniquePower<ValueLeaf,2>>);
+static_assert(not hasChildStorage<UniqueDynamicPower<ValueLeaf>>);
+static_assert(not hasChildStorage<UniqueComposite<ValueLeaf>>);
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("unique nodes");
+
+  using Vector = UniquePower<ValueLeaf,2>;
+  using Vectors = UniqueDynamicPower<Vector>;
+  using Tree = UniqueComposite<Vector,ValueLeaf,Vectors>;
+
+  Tree tree(Vector(ValueLeaf(1),ValueLeaf(2)),
+            ValueLeaf(10),
+            Vectors(Vector(ValueLeaf(3),ValueLeaf(4)),
+                    Vector(ValueLeaf(5),ValueLeaf(6))));
+
+  {
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(tree,visitor);
+    test.check(visitor.count == 7) << "Wrong number of leaves";
+    test.check(visitor.sum == 31) << "Wrong leaf values";
+  }
+
+  test.check(tree.child(_2,1,_0).value == 5) << "Wrong nested child access";
+
+  test.check(tree.childStorageRef(_1).get() == &tree.child(_1))
+    << "childStorageRef() does not point to the child";
+
+  {
+    // transfer ownership in and out of the tree
+    auto leaf = std::make_unique<ValueLeaf>(42);
+    const ValueLeaf* address = leaf.get();
+    tree.child(_0).setChild(1,std::move(leaf));
+    test.check(&tree.child(_0,1) == address) << "setChild() did not take over the passed-in child";
+
+    auto released = tree.child(_0).releaseChild(_1);
+    test.check(released.get() == address) << "releaseChild() returned the wrong child";
+    test.check(not tree.child(_0).childStorageRef(1)) << "releaseChild() did not release the child";
+    tree.child(_0).setChild(_1,ValueLeaf(2));
+  }
+
+  {
+    // copies are deep
+    Tree copy = tree;
+    test.check(&copy.child(_2,0,_1) != &tree.child(_2,0,_1)) << "Copy shares children with the original";
+    copy.child(_2,0,_1).value = 100;
+    test.check(tree.child(_2,0,_1).value == 4) << "Modifying the copy changed the original";
+
+    Tree moved = std::move(copy);
+    test.check(moved.child(_2,0,_1).value == 100) << "Moving lost the children";
+  }
+
+  {
+    // transform a shared tree into a unique tree
+    using SharedVector = Power<ValueLeaf,3>;
+    using SharedTree = Composite<SharedVector,DynamicPower<ValueLeaf>>;
+    SharedTree sharedTree{SharedVector(ValueLeaf(),ValueLeaf(),ValueLeaf()),
+                          DynamicPower<ValueLeaf>(ValueLeaf(),ValueLeaf())};
+
+    using Transformation = Dune::TypeTree::TransformTree<SharedTree,ToUnique>;
+    using Transformed = Transformation::transformed_type;
+    static_assert(std::is_same_v<Transformed,
+                                 UniqueComposite<UniquePower<TransformedLeaf,3>,
+                                                 UniqueDynamicPower<TransformedLeaf>>>);
+    static_assert(std::is_same_v<Transformation::transformed_storage_type,
+                                 std::unique_ptr<Transformed>>);
+
+    Transformed transformed = Transformation::transform(sharedTree,ToUnique{});
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(transformed,visitor);
+    test.check(visitor.count == 5) << "Wrong number of leaves in transformed tree";
+
+    auto transformedStorage = Transformation::transform_storage(
+      std::make_shared<const SharedTree>(sharedTree),ToUnique{});
+    test.check(transformedStorage->child(_1).degree() == 2)
+      << "Wrong degree in transformed dynamic power node";
+  }
+
+  {
+    // the children of a unique tree are transformed by reference, so descriptors cannot retain them
+    using Transformation = Dune::TypeTree::TransformTree<Tree,FromUnique>;
+    auto transformed = Transformation::transform_storage(std::make_shared<const Tree>(tree),FromUnique{});
+    test.check(not transformed->child(_1).source) << "Descriptor retained the storage of a unique child";
+    LeafSum visitor;
+    Dune::TypeTree::applyToTree(*transformed,visitor);
+    test.check(visitor.count == 7) << "Wrong number of leaves in tree transformed from unique tree";
+    test.check(visitor.sum == 31) << "Wrong leaf values in tree transformed from unique tree";
+  }
+
+  return test.exit();
+}
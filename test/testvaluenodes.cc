@@ -0,0 +1,107 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#include <config.h>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/valuenodes.hh>
+#include <dune/typetree/accumulate_static.hh>
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/treepath.hh>
+#include <dune/typetree/visitor.hh>
+
+struct Block : public Dune::TypeTree::LeafNode
+{
+  constexpr Block(std::size_t s = 0) : size(s) {}
+  std::size_t size;
+};
+
+template<class T, std::size_t k>
+struct Power : public Dune::TypeTree::ValuePowerNode<T,k>
+{
+  template<class... C>
+  constexpr Power(C&&... c) : Dune::TypeTree::ValuePowerNode<T,k>(std::forward<C>(c)...) {}
+};
+
+template<class... T>
+struct Composite : public Dune::TypeTree::ValueCompositeNode<T...>
+{
+  template<class... C>
+  constexpr Composite(C&&... c) : Dune::TypeTree::ValueCompositeNode<T...>(std::forward<C>(c)...) {}
+};
+
+using Velocity = Power<Block,3>;
+using Tree = Composite<Velocity,Block>;
+
+constexpr Tree tree{Velocity(Block(2),Block(2),Block(2)),Block(1)};
+
+// computes the offset of each leaf in a blocked vector
+struct OffsetVisitor
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  template<class T, class TreePath>
+  constexpr void leaf(const T& block, TreePath)
+  {
+    offsets[leafIndex++] = size;
+    size += block.size;
+  }
+
+  std::array<std::size_t,4> offsets = {};
+  std::size_t leafIndex = 0;
+  std::size_t size = 0;
+};
+
+constexpr std::array<std::size_t,4> leafOffsets(const Tree& t)
+{
+  OffsetVisitor visitor;
+  Dune::TypeTree::applyToTree(t,visitor);
+  return visitor.offsets;
+}
+
+struct SizeVisitor
+  : public Dune::TypeTree::Experimental::DefaultHybridVisitor
+  , public Dune::TypeTree::StaticTraversal
+  , public Dune::TypeTree::VisitTree
+{
+  template<class T, class TreePath>
+  constexpr std::size_t leaf(const T& block, TreePath, std::size_t size) const
+  {
+    return size + block.size;
+  }
+};
+
+// the tables are stored in read-only data
+constexpr auto offsets = leafOffsets(tree);
+static_assert(offsets == std::array<std::size_t,4>{0,2,4,6});
+static_assert(Dune::TypeTree::Experimental::hybridApplyToTree(tree,SizeVisitor{},std::size_t(0)) == 7);
+
+// value nodes do not hand out shared storage that could outlive them
+template<class Node>
+constexpr bool hasChildStorage = requires(Node& node) { node.childStorage(Dune::Indices::_0); };
+
+static_assert(not hasChildStorage<Velocity>);
+static_assert(not hasChildStorage<Tree>);
+
+int main()
+{
+  using namespace Dune::Indices;
+
+  Dune::TestSuite test("value nodes");
+
+  Tree mutableTree = tree;
+  mutableTree.child(_0).setChild(1,Block(3));
+  test.check(leafOffsets(mutableTree) == std::array<std::size_t,4>{0,2,5,7}) << "Wrong offsets after setChild()";
+  test.check(tree.child(_0,1).size == 2) << "Copy does not own its children";
+  test.check(mutableTree.child(Dune::TypeTree::treePath(_0,2)).size == 2) << "Wrong nested child access";
+
+
+  return test.exit();
+}
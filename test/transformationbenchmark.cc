@@ -0,0 +1,60 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+// Compile-time benchmark for TransformTree. The file instantiates transform_storage() for a
+// generated composite tree with 64 distinct leaf types and about 200 nodes, so the time and memory
+// needed to compile it measure the cost of instantiating the transformation engine, e.g.
+//
+//   make transformationbenchmark VERBOSE=1
+//   /usr/bin/time -v <compile command>
+//
+// The target is not part of the default build.
+
+#include "config.h"
+
+#include <memory>
+#include <utility>
+
+#include "typetreetestutility.hh"
+#include "typetreetargetnodes.hh"
+
+// a distinct leaf type for each index
+template<std::size_t k>
+struct IndexedLeaf : public SimpleLeaf {};
+
+// 8 children, alternating between leaves and power nodes of leaves
+template<std::size_t j, typename Children = std::make_index_sequence<8>>
+struct BenchmarkComposite;
+
+template<std::size_t j, std::size_t... c>
+struct BenchmarkComposite<j,std::index_sequence<c...>>
+{
+  using type = SimpleComposite<std::conditional_t<c % 2 == 0,
+                                                  IndexedLeaf<8*j+c>,
+                                                  SimplePower<IndexedLeaf<8*j+c>,3>>...>;
+};
+
+template<std::size_t j>
+using BenchmarkSubtree = SimpleComposite<typename BenchmarkComposite<j>::type,
+                                         SimplePower<typename BenchmarkComposite<j>::type,2>>;
+
+template<typename Children = std::make_index_sequence<8>>
+struct BenchmarkTree;
+
+template<std::size_t... j>
+struct BenchmarkTree<std::index_sequence<j...>>
+{
+  using type = SimpleComposite<BenchmarkSubtree<j>...>;
+};
+
+using Tree = BenchmarkTree<>::type;
+using Transformation = Dune::TypeTree::TransformTree<Tree,TestTransformation>;
+
+int main()
+{
+  using TransformStorage = Transformation::transformed_storage_type (*)(std::shared_ptr<const Tree>, const TestTransformation&);
+  TransformStorage transform = &Transformation::transform_storage;
+  return transform == nullptr;
+}
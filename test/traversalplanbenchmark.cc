@@ -0,0 +1,108 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+
+// Run-time benchmark for TraversalPlan. The program traverses trees with nested dynamic power
+// nodes many times, once with applyToTree() and once by replaying a plan, with a visitor that only
+// implements leaf(), and prints the time per traversal, e.g.
+//
+//   make traversalplanbenchmark && ./traversalplanbenchmark
+//
+// The target is not part of the default build.
+
+#include "config.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <dune/typetree/traversal.hh>
+#include <dune/typetree/traversalplan.hh>
+#include <dune/typetree/visitor.hh>
+
+#include "typetreetestnodes.hh"
+
+// sums the leaf values, the other callbacks are inherited from DefaultVisitor
+struct LeafSum
+  : public Dune::TypeTree::TreeVisitor
+  , public Dune::TypeTree::DynamicTraversal
+{
+  LeafSum(long& s) : sum(s) {}
+
+  template<class T, class TreePath>
+  void leaf(T&& t, TreePath)
+  {
+    sum += t.value;
+  }
+
+  long& sum;
+};
+
+// builds a node with the given degree for all dynamic power nodes
+template<class Node>
+std::shared_ptr<Node> build(std::size_t degree, int& value)
+{
+  if constexpr (Node::isLeaf)
+    return std::make_shared<Node>(value++);
+  else
+  {
+    typename Node::NodeStorage children;
+    for (std::size_t i = 0; i < degree; ++i)
+      children.push_back(build<typename Node::ChildType>(degree,value));
+    return std::make_shared<Node>(children);
+  }
+}
+
+template<class F>
+double nanosecondsPerCall(F&& f, std::size_t n)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < n; ++i)
+    f();
+  std::chrono::duration<double,std::nano> time = std::chrono::steady_clock::now() - start;
+  return time.count() / n;
+}
+
+// a composite of the dynamic subtree and a power node of 3 leaves
+template<class Dynamic>
+void benchmark(const std::string& name, std::size_t degree)
+{
+  using Tree = Composite<Dynamic,Power<ValueLeaf,3>>;
+  int value = 0;
+  Tree tree(build<Dynamic>(degree,value),std::make_shared<Power<ValueLeaf,3>>(ValueLeaf(1),ValueLeaf(2),ValueLeaf(3)));
+
+  const std::size_t n = 2000000;
+  long sum = 0;
+
+  double direct = nanosecondsPerCall([&]{
+      Dune::TypeTree::applyToTree(tree,LeafSum(sum));
+    },n);
+
+  Dune::TypeTree::TraversalPlan<Tree,LeafSum> plan(tree);
+  double replay = nanosecondsPerCall([&]{
+      plan.apply(tree,LeafSum(sum));
+    },n);
+
+  std::cout << name << ": applyToTree() " << direct << " ns, TraversalPlan " << replay
+            << " ns per traversal (" << plan.steps().size() << " steps, checksum " << sum << ")"
+            << std::endl;
+}
+
+int main()
+{
+  using L1 = DynamicPower<ValueLeaf>;
+  using L2 = DynamicPower<L1>;
+  using L4 = DynamicPower<DynamicPower<L2>>;
+
+  // 36 + 3 leaves below two wide levels
+  benchmark<L2>("2 levels of degree 6",6);
+  // 81 + 3 leaves below four narrow levels
+  benchmark<L4>("4 levels of degree 3",3);
+  // 16 + 3 leaves below four narrow levels
+  benchmark<L4>("4 levels of degree 2",2);
+
+  return 0;
+}
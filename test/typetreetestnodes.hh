@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-3.0-or-later OR LicenseRef-GPL-2.0-only-with-PDELab-exception
+#ifndef DUNE_TYPETREE_TEST_TYPETREETESTNODES_HH
+#define DUNE_TYPETREE_TEST_TYPETREETESTNODES_HH
+
+#include <cstddef>
+#include <utility>
+
+#include <dune/typetree/compositenode.hh>
+#include <dune/typetree/dynamicpowernode.hh>
+#include <dune/typetree/leafnode.hh>
+#include <dune/typetree/nodetags.hh>
+#include <dune/typetree/powernode.hh>
+
+// Nodes for tests. They provide an ImplementationTag, so they can be used with tree
+// transformations, and the inner nodes forward all constructor arguments to the TypeTree base
+// classes.
+
+struct ValueLeaf : public Dune::TypeTree::LeafNode
+{
+  typedef Dune::TypeTree::LeafNodeTag ImplementationTag;
+
+  ValueLeaf(int v = 0) : value(v) {}
+  int value;
+};
+
+template<class T, std::size_t k>
+struct Power : public Dune::TypeTree::PowerNode<T,k>
+{
+  typedef Dune::TypeTree::PowerNodeTag ImplementationTag;
+
+  template<class... C>
+  Power(C&&... c) : Dune::TypeTree::PowerNode<T,k>(std::forward<C>(c)...) {}
+};
+
+template<class T>
+struct DynamicPower : public Dune::TypeTree::DynamicPowerNode<T>
+{
+  typedef Dune::TypeTree::DynamicPowerNodeTag ImplementationTag;
+
+  template<class... C>
+  DynamicPower(C&&... c) : Dune::TypeTree::DynamicPowerNode<T>(std::forward<C>(c)...) {}
+};
+
+template<class... T>
+struct Composite : public Dune::TypeTree::CompositeNode<T...>
+{
+  typedef Dune::TypeTree::CompositeNodeTag ImplementationTag;
+
+  template<class... C>
+  Composite(C&&... c) : Dune::TypeTree::CompositeNode<T...>(std::forward<C>(c)...) {}
+};
+
+#endif // DUNE_TYPETREE_TEST_TYPETREETESTNODES_HH